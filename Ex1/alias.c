@@ -0,0 +1,103 @@
+/* Alias tables for discrete distributions (Walker's method, with the stable
+   construction of Vose).  Each of the n columns holds probability 1/n, split
+   between its own value and at most one other value, the alias.  The table is
+   built by pairing columns whose scaled probability is below 1 with columns
+   whose scaled probability is above 1, and topping up the small ones from the
+   large ones until every column is full.
+
+   The distribution is given as the cumulative distribution function
+   prob_distrib[1..n], as read by the models, so the point probabilities are
+   the differences of successive entries.  They are scaled by the last entry,
+   so a function that stops a little short of 1.0 is still a distribution.
+   The scaling is done in double precision, so the column probabilities match
+   the input to float accuracy even for thousands of values. */
+
+#include <stdlib.h>
+#include "alias.h"
+
+/* Build the alias table for the cumulative distribution prob_distrib[1..n].
+   Return 0 on success, or -1 if n < 1 or memory is exhausted. */
+
+int alias_build(alias_table *table, const float prob_distrib[], int n)
+{
+    double *scaled;
+    int    *small, *large, num_small = 0, num_large = 0, i, s, l;
+
+    table->n     = 0;
+    table->prob  = NULL;
+    table->alias = NULL;
+    if (n < 1)
+        return -1;
+
+    table->prob  = (float *) malloc(n * sizeof(float));
+    table->alias = (int *) malloc(n * sizeof(int));
+    scaled       = (double *) malloc(n * sizeof(double));
+    small        = (int *) malloc(n * sizeof(int));
+    large        = (int *) malloc(n * sizeof(int));
+    if (table->prob == NULL || table->alias == NULL || scaled == NULL ||
+        small == NULL || large == NULL) {
+        free(scaled);
+        free(small);
+        free(large);
+        alias_free(table);
+        return -1;
+    }
+    table->n = n;
+
+    // Scale each point probability by n, so a full column holds 1.
+
+    for (i = 0; i < n; ++i) {
+        scaled[i] = (double) prob_distrib[i + 1] - (i > 0 ? prob_distrib[i] : 0.0);
+        scaled[i] = scaled[i] * n / prob_distrib[n];
+        if (scaled[i] < 1.0)
+            small[num_small++] = i;
+        else
+            large[num_large++] = i;
+    }
+
+    // Fill each small column from a large one.  The large column gives up
+    // what the small one lacks, and moves to the small list if it drops
+    // below 1.
+
+    while (num_small > 0 && num_large > 0) {
+        s = small[--num_small];
+        l = large[num_large - 1];
+        table->prob[s]  = (float) scaled[s];
+        table->alias[s] = l + 1;
+        scaled[l]      -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            --num_large;
+            small[num_small++] = l;
+        }
+    }
+
+    // Columns left on either list are full up to rounding error.
+
+    while (num_large > 0) {
+        l = large[--num_large];
+        table->prob[l]  = 1.0;
+        table->alias[l] = l + 1;
+    }
+    while (num_small > 0) {
+        s = small[--num_small];
+        table->prob[s]  = 1.0;
+        table->alias[s] = s + 1;
+    }
+
+    free(scaled);
+    free(small);
+    free(large);
+    return 0;
+}
+
+
+/* Release the memory of an alias table. */
+
+void alias_free(alias_table *table)
+{
+    free(table->prob);
+    free(table->alias);
+    table->n     = 0;
+    table->prob  = NULL;
+    table->alias = NULL;
+}
@@ -0,0 +1,33 @@
+/* The following declarations are for use of the alias-method sampler, which
+   draws from a discrete distribution on 1 through n in constant time from a
+   single U(0,1) random number.  A table is built once from the cumulative
+   distribution function, in the 1-based layout the models read from their
+   input files, and released with alias_free. */
+
+#ifndef _ALIAS_H
+#define _ALIAS_H
+
+typedef struct {
+    int    n;      // Number of values in the distribution.
+    float *prob;   // Probability of keeping column i (0-based).
+    int   *alias;  // Value returned when column i is not kept.
+} alias_table;
+
+int  alias_build(alias_table *table, const float prob_distrib[], int n);
+void alias_free(alias_table *table);
+
+/* Return a value in 1 through n from the U(0,1) random number u.  The integer
+   part of u * n picks a column and the fractional part decides between the
+   column's own value and its alias. */
+
+static inline int alias_sample(const alias_table *table, float u)
+{
+    double x = (double) u * table->n;
+    int    i = (int) x;
+
+    if (i >= table->n)
+        i = table->n - 1;
+    return x - i < table->prob[i] ? i + 1 : table->alias[i];
+}
+
+#endif // _ALIAS_H
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include "aout.h"
+
+// Each record starts with a head and is padded to a multiple of ALIGN, so
+// the values copied after the head are aligned for any type.
+#define ALIGN     sizeof(max_align_t)
+#define ROUND(n)  (((n) + ALIGN - 1) / ALIGN * ALIGN)
+#define HEAD      ROUND(sizeof(record_head))
+
+typedef struct {
+    aout_format format;        // NULL for text.
+    size_t      size;          // Bytes to the next record.
+} record_head;
+
+// State shared with the writer.  A buffer belongs to one side at a time:
+// the model posts ready when it hands one over, and the writer posts free
+// when it gives one back.
+static _Alignas(max_align_t) unsigned char buffer[2][AOUT_BUFFER];
+static size_t    used[2];
+static int       filling;                    // Buffer the model is filling.
+static sem_t     ready, free_buffers;
+static pthread_t writer;
+static FILE      *file;
+static int       running, stopping, registered;
+
+// Wait on a semaphore, through any interruptions by signals.
+static void wait_on(sem_t *s){
+    while (sem_wait(s) != 0)
+        ;
+}
+
+// Format and write the records of buffer b, and empty it.
+static void write_buffer(int b){
+    const record_head *h;
+    size_t            at;
+
+    for (at = 0; at < used[b]; at += h->size){
+        h = (const record_head*) &buffer[b][at];
+        if (h->format != NULL)
+            h->format(file, (const unsigned char*) h + HEAD);
+        else
+            fputs((const char*) h + HEAD, file);
+    }
+    used[b] = 0;
+}
+
+// Body of the writer thread: write the buffers in the order they are handed
+// over, until told to stop.
+static void *write_loop(void *arg){
+    int b = 0;
+
+    (void) arg;
+    for (;;){
+        wait_on(&ready);
+        if (stopping)
+            break;
+        write_buffer(b);
+        fflush(file);
+        sem_post(&free_buffers);
+        b ^= 1;
+    }
+    return NULL;
+}
+
+// Hand the buffer being filled to the writer, and take the other one once
+// the writer is done with it.
+static void hand_off(void){
+    sem_post(&ready);
+    filling ^= 1;
+    wait_on(&free_buffers);
+}
+
+// Start a writer for f.  Return 0, or -1 if it cannot be started, in which
+// case records are written at once.
+int aout_open(FILE *f){
+    file     = f;
+    filling  = 0;
+    used[0]  = used[1] = 0;
+    stopping = 0;
+    if (!registered){
+        atexit(aout_close);
+        registered = 1;
+    }
+    if (f == NULL || sem_init(&ready, 0, 0) < 0)
+        return -1;
+    if (sem_init(&free_buffers, 0, 1) < 0){
+        sem_destroy(&ready);
+        return -1;
+    }
+    if (pthread_create(&writer, NULL, write_loop, NULL) != 0){
+        sem_destroy(&ready);
+        sem_destroy(&free_buffers);
+        return -1;
+    }
+    running = 1;
+    return 0;
+}
+
+// Copy size bytes of record to be formatted by format on the writer thread.
+// A record too big for a buffer is written at once, after the ones before.
+void aout_put(aout_format format, const void *record, size_t size){
+    size_t      need = HEAD + ROUND(size);
+    record_head *h;
+
+    if (!running || need > AOUT_BUFFER){
+        aout_flush();
+        format(file, record);
+        return;
+    }
+    if (used[filling] + need > AOUT_BUFFER)
+        hand_off();
+    h = (record_head*) &buffer[filling][used[filling]];
+    h->format = format;
+    h->size   = need;
+    memcpy((unsigned char*) h + HEAD, record, size);
+    used[filling] += need;
+}
+
+// Format text now, like fprintf, and queue it to be written in order.
+void aout_printf(const char *format, ...){
+    va_list     args, copy;
+    record_head *h;
+    size_t      need;
+    int         n;
+
+    va_start(args, format);
+    va_copy(copy, args);
+    n = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    need = HEAD + ROUND((size_t) n + 1);
+    if (!running || n < 0 || need > AOUT_BUFFER){
+        aout_flush();
+        vfprintf(file, format, args);
+    }
+    else {
+        if (used[filling] + need > AOUT_BUFFER)
+            hand_off();
+        h = (record_head*) &buffer[filling][used[filling]];
+        h->format = NULL;
+        h->size   = need;
+        vsnprintf((char*) h + HEAD, n + 1, format, args);
+        used[filling] += need;
+    }
+    va_end(args);
+}
+
+// Hand over whatever is buffered, and wait until the writer has written
+// and flushed it.
+void aout_flush(void){
+    if (!running)
+        return;
+    if (used[filling] > 0)
+        hand_off();
+    wait_on(&free_buffers);
+    sem_post(&free_buffers);
+}
+
+// Write whatever is buffered and stop the writer.  The file stays open.
+void aout_close(void){
+    if (!running)
+        return;
+    aout_flush();
+    stopping = 1;
+    sem_post(&ready);
+    pthread_join(writer, NULL);
+    sem_destroy(&ready);
+    sem_destroy(&free_buffers);
+    running = 0;
+}
@@ -0,0 +1,69 @@
+/* Branchless next-event selection for models with a small, fixed set of event
+   types.  The event-time array is indexed 1 through num_events as in the
+   timing functions, with slot 0 holding the 1.0e+29 cutoff and the slots past
+   num_events holding 1.0e+30, so every EVSEL_WIDTH block can be compared
+   without a bound check.
+
+   Selection is an argmin in two passes: a vertical pass that keeps, for each
+   lane, the smallest time seen across the blocks, followed by a tournament
+   between the EVSEL_WIDTH lanes.  Each comparison selects with a mask rather
+   than a branch, so the compiler can keep the lanes in vector registers.  Ties
+   are broken toward the lower event type, which is the event the original
+   linear scan returns.  Event type 0 is returned when no event is scheduled
+   before 1.0e+29. */
+
+#include "evsel.h"
+
+/* Pad the event-time array for use with evsel_next. */
+
+void evsel_pad(float time_next_event[], int num_events)
+{
+    int i;
+
+    time_next_event[0] = 1.0e+29;
+    for (i = num_events + 1; i < EVSEL_SIZE(num_events); ++i)
+        time_next_event[i] = 1.0e+30;
+}
+
+
+/* Return the type of the next event, and its time in min_time_next_event. */
+
+int evsel_next(const float time_next_event[], int num_events,
+               float *min_time_next_event)
+{
+    float time[EVSEL_WIDTH];
+    int   type[EVSEL_WIDTH], size, base, lane, width, take;
+
+    /* Load the first block, which includes the 1.0e+29 cutoff in slot 0. */
+
+    for (lane = 0; lane < EVSEL_WIDTH; ++lane) {
+        time[lane] = time_next_event[lane];
+        type[lane] = lane;
+    }
+
+    /* Fold any further blocks into the lanes.  Later blocks only hold higher
+       event types, so a lane is replaced only on a strictly smaller time. */
+
+    size = EVSEL_SIZE(num_events);
+    for (base = EVSEL_WIDTH; base < size; base += EVSEL_WIDTH)
+        for (lane = 0; lane < EVSEL_WIDTH; ++lane) {
+            take       = time_next_event[base + lane] < time[lane];
+            time[lane] = take ? time_next_event[base + lane] : time[lane];
+            type[lane] = take ? base + lane : type[lane];
+        }
+
+    /* Play the tournament between the lanes, halving the field each round.
+       Equal times go to the lower event type. */
+
+    for (width = EVSEL_WIDTH / 2; width > 0; width /= 2)
+        for (lane = 0; lane < width; ++lane) {
+            take = (time[lane + width] <  time[lane]) |
+                   ((time[lane + width] == time[lane]) &
+                    (type[lane + width] <  type[lane]));
+            time[lane] = take ? time[lane + width] : time[lane];
+            type[lane] = take ? type[lane + width] : type[lane];
+        }
+
+    *min_time_next_event = time[0];
+    return type[0];
+}
@@ -0,0 +1,22 @@
+/* The following declarations are for use of the next-event selector evsel,
+   which replaces the compare-and-branch scan in the timing functions of the
+   fixed-array models.  A time_next_event array used with evsel must be
+   declared with EVSEL_SIZE(num_events) entries, aligned to EVSEL_ALIGN bytes,
+   and padded by evsel_pad before the first call to evsel_next. */
+
+#ifndef _EVSEL_H
+#define _EVSEL_H
+
+#define EVSEL_WIDTH 8   /* Number of event slots compared side by side. */
+#define EVSEL_ALIGN 32  /* Alignment (in bytes) of an event-time array. */
+
+/* Number of entries needed for events 1 through n plus the sentinel slot 0,
+   rounded up to a whole number of EVSEL_WIDTH blocks. */
+
+#define EVSEL_SIZE(n) ((((n) + EVSEL_WIDTH) / EVSEL_WIDTH) * EVSEL_WIDTH)
+
+void evsel_pad(float time_next_event[], int num_events);
+int  evsel_next(const float time_next_event[], int num_events,
+                float *min_time_next_event);
+
+#endif // _EVSEL_H
@@ -2,38 +2,90 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
-
-int   amount, bigs, initial_inv_level, inv_level, next_event_type, num_events,
-      num_months, num_values_demand, smalls;
+#include "evsel.h"    /* Header file for next-event selector. */
+#include "alias.h"    /* Header file for alias-method sampler. */
+#include "telem.h"    /* Header file for live telemetry. */
+#include "aout.h"     /* Header file for the background report writer. */
+
+/* Totals of one policy, for its report.  The cost parameters do not change
+   between policies, so write_report reads them from the globals. */
+
+typedef struct {
+    int   smalls, bigs;
+    float total_ordering_cost, area_holding, area_shortage;
+} policy_report;
+
+int   amount, bigs, fast_forward, initial_inv_level, inv_level,
+      next_event_type, num_events, num_months, num_values_demand, smalls,
+      telemetry;
 float area_holding, area_shortage, holding_cost, incremental_cost, maxlag,
-      mean_interdemand, minlag, prob_distrib_demand[26], setup_cost,
-      shortage_cost, sim_time, time_last_event, time_next_event[5],
-      total_ordering_cost;
+      mean_interdemand, minlag, *prob_distrib_demand, setup_cost,
+      shortage_cost, sim_time, time_last_event, total_ordering_cost;
+_Alignas(EVSEL_ALIGN) float time_next_event[EVSEL_SIZE(4)];
+alias_table alias_demand;
+unsigned long long num_events_done, next_check;
 FILE  *infile, *outfile;
 
 void  initialize(void);
 void  timing(void);
 void  order_arrival(void);
 void  demand(void);
+void  demand_run(void);
 void  evaluate(void);
 void  report(void);
+void  write_report(FILE *, const void *);
 void  update_time_avg_stats(void);
 float expon(float mean);
-int   random_integer(float prob_distrib []);
+int   random_integer(alias_table *table);
 float uniform(float a, float b);
+void  publish_telemetry(int policy);
 
 
-int main()  /* Main function. */
+int main(int argc, char *argv[])  /* Main function. */
 {
     int i, num_policies;
 
+    /* Check for the options -f (fast-forward through runs of demands),
+       -r name (draw the random numbers from the named generator) and
+       -m name (publish live snapshots to the shared-memory segment name). */
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "-m") == 0) &&
+            i + 1 == argc) {
+            fprintf(stderr, "Usage: inv [-f] [-r name] [-m name]\n");
+            exit(1);
+        }
+        if (strcmp(argv[i], "-f") == 0)
+            fast_forward = 1;
+        else if (strcmp(argv[i], "-r") == 0) {
+            if (lcgrandbk(lcgrandid(argv[++i])) < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i], "-m") == 0) {
+            if (telem_open(argv[++i], "inv") < 0) {
+                fprintf(stderr, "Cannot create telemetry segment %s\n",
+                        argv[i]);
+                exit(1);
+            }
+            telemetry  = 1;
+            next_check = TELEM_CHECK;
+        }
+    }
+
     /* Open input and output files. */
 
     infile  = fopen("inv.in",  "r");
     outfile = fopen("inv.out", "w");
 
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
     /* Specify the number of events for the timing function. */
 
     num_events = 4;
@@ -44,29 +96,43 @@ int main()  /* Main function. */
            &initial_inv_level, &num_months, &num_policies, &num_values_demand,
            &mean_interdemand, &setup_cost, &incremental_cost, &holding_cost,
            &shortage_cost, &minlag, &maxlag);
+    prob_distrib_demand = (float *) malloc((num_values_demand + 1) *
+                                           sizeof(float));
+    if (prob_distrib_demand == NULL) {
+        aout_printf("\nInsufficient memory for %d demand sizes",
+                    num_values_demand);
+        exit(2);
+    }
     for (i = 1; i <= num_values_demand; ++i)
         fscanf(infile, "%f", &prob_distrib_demand[i]);
 
+    /* Build the alias table for the demand sizes once, before any run. */
+
+    if (alias_build(&alias_demand, prob_distrib_demand, num_values_demand) < 0) {
+        aout_printf("\nCannot build the demand-size distribution");
+        exit(2);
+    }
+
     /* Write report heading and input parameters. */
 
-    fprintf(outfile, "Single-product inventory system\n\n");
-    fprintf(outfile, "Initial inventory level%24d items\n\n",
-            initial_inv_level);
-    fprintf(outfile, "Number of demand sizes%25d\n\n", num_values_demand);
-    fprintf(outfile, "Distribution function of demand sizes  ");
+    aout_printf("Single-product inventory system\n\n");
+    aout_printf("Initial inventory level%24d items\n\n",
+                initial_inv_level);
+    aout_printf("Number of demand sizes%25d\n\n", num_values_demand);
+    aout_printf("Distribution function of demand sizes  ");
     for (i = 1; i <= num_values_demand; ++i)
-        fprintf(outfile, "%8.3f", prob_distrib_demand[i]);
-    fprintf(outfile, "\n\nMean interdemand time%26.2f\n\n", mean_interdemand);
-    fprintf(outfile, "Delivery lag range%29.2f to%10.2f months\n\n", minlag,
-            maxlag);
-    fprintf(outfile, "Length of the simulation%23d months\n\n", num_months);
-    fprintf(outfile, "K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
-            setup_cost, incremental_cost, holding_cost, shortage_cost);
-    fprintf(outfile, "Number of policies%29d\n\n", num_policies);
-    fprintf(outfile, "                 Average        Average");
-    fprintf(outfile, "        Average        Average\n");
-    fprintf(outfile, "  Policy       total cost    ordering cost");
-    fprintf(outfile, "  holding cost   shortage cost");
+        aout_printf("%8.3f", prob_distrib_demand[i]);
+    aout_printf("\n\nMean interdemand time%26.2f\n\n", mean_interdemand);
+    aout_printf("Delivery lag range%29.2f to%10.2f months\n\n", minlag,
+                maxlag);
+    aout_printf("Length of the simulation%23d months\n\n", num_months);
+    aout_printf("K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+                setup_cost, incremental_cost, holding_cost, shortage_cost);
+    aout_printf("Number of policies%29d\n\n", num_policies);
+    aout_printf("                 Average        Average");
+    aout_printf("        Average        Average\n");
+    aout_printf("  Policy       total cost    ordering cost");
+    aout_printf("  holding cost   shortage cost");
 
     /* Run the simulation varying the inventory policy. */
 
@@ -97,7 +163,10 @@ int main()  /* Main function. */
                     order_arrival();
                     break;
                 case 2:
-                    demand();
+                    if (fast_forward)
+                        demand_run();
+                    else
+                        demand();
                     break;
                 case 4:
                     evaluate();
@@ -107,6 +176,17 @@ int main()  /* Main function. */
                     break;
             }
 
+            /* Publish a snapshot now and then, checking the clock only
+               every TELEM_CHECK events.  A fast-forward demand run counts
+               many events at once, so the count is tested against the next
+               check rather than for a multiple of TELEM_CHECK. */
+
+            if (telemetry && ++num_events_done >= next_check) {
+                next_check = num_events_done + TELEM_CHECK;
+                if (telem_due())
+                    publish_telemetry(i);
+            }
+
         /* If the event just executed was not the end-simulation event (type 3),
            continue simulating.  Otherwise, end the simulation for the current
            (s,S) pair and go on to the next pair (if any). */
@@ -116,7 +196,12 @@ int main()  /* Main function. */
 
     /* End the simulations. */
 
+    if (telemetry)
+        telem_close(sim_time, num_events_done);
+    alias_free(&alias_demand);
+    free(prob_distrib_demand);
     fclose(infile);
+    aout_close();
     fclose(outfile);
 
     return 0;
@@ -140,6 +225,10 @@ void initialize(void)  /* Initialization function. */
     area_holding        = 0.0;
     area_shortage       = 0.0;
 
+    /* Pad the event list for the next-event selector. */
+
+    evsel_pad(time_next_event, num_events);
+
     /* Initialize the event list.  Since no order is outstanding, the order-
        arrival event is eliminated from consideration. */
 
@@ -152,18 +241,12 @@ void initialize(void)  /* Initialization function. */
 
 void timing(void)  /* Timing function. */
 {
-    int   i;
-    float min_time_next_event = 1.0e+29;
-
-    next_event_type = 0;
+    float min_time_next_event;
 
     /* Determine the event type of the next event to occur. */
 
-    for (i = 1; i <= num_events; ++i)
-        if (time_next_event[i] < min_time_next_event) {
-            min_time_next_event = time_next_event[i];
-            next_event_type     = i;
-        }
+    next_event_type = evsel_next(time_next_event, num_events,
+                                 &min_time_next_event);
 
     /* Check to see whether the event list is empty. */
 
@@ -171,7 +254,7 @@ void timing(void)  /* Timing function. */
 
         /* The event list is empty, so stop the simulation */
 
-        fprintf(outfile, "\nEvent list empty at time %f", sim_time);
+        aout_printf("\nEvent list empty at time %f", sim_time);
         exit(1);
     }
 
@@ -198,7 +281,7 @@ void demand(void)  /* Demand event function. */
 {
     /* Decrement the inventory level by a generated demand size. */
 
-    inv_level -= random_integer(prob_distrib_demand);
+    inv_level -= random_integer(&alias_demand);
 
     /* Schedule the time of the next demand. */
 
@@ -206,6 +289,33 @@ void demand(void)  /* Demand event function. */
 }
 
 
+void demand_run(void)  /* Fast-forward demand function. */
+{
+    /* Process this demand and every demand after it that comes before the
+       next order arrival, evaluation or end of the simulation, without going
+       back through the timing function.  The test for the next demand breaks
+       ties as the timing function does: an order arrival at the same time
+       comes first, and an evaluation or end of the simulation comes after.
+       The random numbers are drawn and the areas accumulated in the same
+       order and precision as by demand(), so the results are identical. */
+
+    for (;;) {
+        inv_level          -= random_integer(&alias_demand);
+        time_next_event[2]  = sim_time + expon(mean_interdemand);
+
+        if (time_next_event[2] >= time_next_event[1] ||
+            time_next_event[2] >  time_next_event[3] ||
+            time_next_event[2] >  time_next_event[4])
+            return;
+
+        sim_time = time_next_event[2];
+        update_time_avg_stats();
+        if (telemetry)
+            ++num_events_done;
+    }
+}
+
+
 void evaluate(void)  /* Inventory-evaluation event function. */
 {
     /* Check whether the inventory level is less than smalls. */
@@ -232,20 +342,63 @@ void evaluate(void)  /* Inventory-evaluation event function. */
 
 void report(void)  /* Report generator function. */
 {
+    policy_report r;
+
+    /* Hand a copy of the totals to the writer. */
+
+    r.smalls              = smalls;
+    r.bigs                = bigs;
+    r.total_ordering_cost = total_ordering_cost;
+    r.area_holding        = area_holding;
+    r.area_shortage       = area_shortage;
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     costs of a policy, on
+                                                     the writer thread. */
+{
+    const policy_report *r = record;
+
     /* Compute and write estimates of desired measures of performance. */
 
     float avg_holding_cost, avg_ordering_cost, avg_shortage_cost;
 
-    avg_ordering_cost = total_ordering_cost / num_months;
-    avg_holding_cost  = holding_cost * area_holding / num_months;
-    avg_shortage_cost = shortage_cost * area_shortage / num_months;
-    fprintf(outfile, "\n\n(%3d,%3d)%15.2f%15.2f%15.2f%15.2f",
-            smalls, bigs,
+    avg_ordering_cost = r->total_ordering_cost / num_months;
+    avg_holding_cost  = holding_cost * r->area_holding / num_months;
+    avg_shortage_cost = shortage_cost * r->area_shortage / num_months;
+    fprintf(out, "\n\n(%3d,%3d)%15.2f%15.2f%15.2f%15.2f",
+            r->smalls, r->bigs,
             avg_ordering_cost + avg_holding_cost + avg_shortage_cost,
             avg_ordering_cost, avg_holding_cost, avg_shortage_cost);
 }
 
 
+void publish_telemetry(int policy)  /* Publish the state and running
+                                       averages of policy "policy". */
+{
+    int i, scheduled = 0;
+
+    /* Count the events on the list, that is, those not at 1.0e+30. */
+
+    for (i = 1; i <= num_events; ++i)
+        if (time_next_event[i] < 1.0e+29)
+            ++scheduled;
+
+    telem_value(0, "Inventory level", inv_level);
+    telem_value(1, "Policy s", smalls);
+    telem_value(2, "Policy S", bigs);
+    telem_value(3, "Ordering cost so far", total_ordering_cost / sim_time);
+    telem_value(4, "Holding cost so far",
+                holding_cost * area_holding / sim_time);
+    telem_value(5, "Shortage cost so far",
+                shortage_cost * area_shortage / sim_time);
+    telem_value(6, "Event list size", scheduled);
+    telem_publish(policy, sim_time, num_events_done);
+}
+
+
 void update_time_avg_stats(void)  /* Update area accumulators for time-average
                                      statistics. */
 {
@@ -276,22 +429,13 @@ float expon(float mean)  /* Exponential variate generation function. */
 }
 
 
-int random_integer(float prob_distrib[])  /* Random integer generation
-                                             function. */
+int random_integer(alias_table *table)  /* Random integer generation
+                                           function. */
 {
-    int   i;
-    float u;
-
-    /* Generate a U(0,1) random variate. */
-
-    u = lcgrand(1);
-
-    /* Return a random integer in accordance with the (cumulative) distribution
-       function prob_distrib. */
+    /* Return a random integer in accordance with the distribution held in the
+       alias table, using a single U(0,1) random variate. */
 
-    for (i = 1; u >= prob_distrib[i]; ++i)
-        ;
-    return i;
+    return alias_sample(table, lcgrand(1));
 }
 
 
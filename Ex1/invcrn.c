@@ -0,0 +1,401 @@
+/* External definitions for the inventory system of inv.c, with every policy
+   run on the same demands.
+
+   In inv.c the policies draw their demands one after another from stream
+   1, so each sees different demands, and the differences between their
+   costs mix the effect of the policy with that of the demands.  Here the
+   demands of a replication, the time and size of each up to the end of the
+   simulation, are generated once into a compact array, with one random
+   number for the delivery lag of an order placed at each monthly
+   evaluation, and every policy replays that array.  Since the arrays are
+   only read once made, the (policy, replication) pairs are replayed on many
+   threads at once with no locking, and the costs do not depend on the
+   number of threads.  Sharing the demands makes the comparison of two
+   policies far more precise than with independent demands, and the report
+   gives the confidence interval of each policy's difference from the best.
+
+   The demands are drawn on stream 1, the times kept as the single-precision
+   absolute times inv.c uses and the sizes as one byte each, so a
+   replication of inv.in takes about 6 kB.  The inputs and policies are read
+   from inv.in, and invcrn.in gives the number of replications and of
+   threads, 0 for one per processor. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "alias.h"    /* Header file for alias-method sampler. */
+
+#define MAX_THREADS 64       /* Limit on threads. */
+#define NEVER       1.0e+30  /* Time of an event that is not scheduled. */
+
+/* The demands of one replication. */
+
+typedef struct {
+    int           num_demands;
+    float         *time;       /* Absolute time of each demand. */
+    unsigned char *size;       /* Size of each demand. */
+    float         *lag;        /* U(0,1) for the lag of an order placed at
+                                  each month's evaluation. */
+} demand_cache;
+
+/* Costs of one policy on one replication. */
+
+typedef struct {
+    float ordering, holding, shortage;
+} cost;
+
+int          initial_inv_level, num_months, num_policies, num_values_demand,
+             num_reps, num_threads, *smalls, *bigs;
+float        holding_cost, incremental_cost, maxlag, mean_interdemand, minlag,
+             *prob_distrib_demand, setup_cost, shortage_cost;
+long         num_demands_total;
+alias_table  alias_demand;
+demand_cache *caches;
+cost         *costs;       /* Policy p, replication r at p * num_reps + r. */
+FILE         *infile, *crnfile, *outfile;
+
+void   read_input(void);
+void   generate(demand_cache *);
+void   *replay_thread(void *);
+void   replay(int policy, const demand_cache *, cost *);
+void   report(double generate_seconds, double replay_seconds);
+double t_crit(int df);
+float  expon(float mean);
+
+
+int main(void)  /* Main function. */
+{
+    pthread_t       threads[MAX_THREADS];
+    long            k;
+    int             r;
+    struct timespec wall_start, wall_mid, wall_stop;
+
+    /* Open input and output files, and read the inputs. */
+
+    infile  = fopen("inv.in",  "r");
+    crnfile = fopen("invcrn.in", "r");
+    outfile = fopen("invcrn.out", "w");
+    read_input();
+
+    /* Generate the demands of every replication. */
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    for (r = 0; r < num_reps; ++r)
+        generate(&caches[r]);
+    clock_gettime(CLOCK_MONOTONIC, &wall_mid);
+
+    /* Replay them under every policy, thread k taking the pairs k,
+       k + num_threads, and so on. */
+
+    for (k = 1; k < num_threads; ++k)
+        if (pthread_create(&threads[k], NULL, replay_thread, (void *) k) != 0) {
+            fprintf(outfile, "\nCannot start thread %ld", k);
+            exit(2);
+        }
+    replay_thread((void *) 0);
+    for (k = 1; k < num_threads; ++k)
+        pthread_join(threads[k], NULL);
+    clock_gettime(CLOCK_MONOTONIC, &wall_stop);
+
+    /* Invoke the report generator and end the simulations. */
+
+    report((wall_mid.tv_sec - wall_start.tv_sec) +
+           (wall_mid.tv_nsec - wall_start.tv_nsec) / 1.0e+9,
+           (wall_stop.tv_sec - wall_mid.tv_sec) +
+           (wall_stop.tv_nsec - wall_mid.tv_nsec) / 1.0e+9);
+
+    for (r = 0; r < num_reps; ++r) {
+        free(caches[r].time);
+        free(caches[r].size);
+        free(caches[r].lag);
+    }
+    free(caches);
+    free(costs);
+    free(smalls);
+    free(bigs);
+    alias_free(&alias_demand);
+    free(prob_distrib_demand);
+    fclose(infile);
+    fclose(crnfile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void read_input(void)  /* Read the inputs, policies and run sizes. */
+{
+    int i;
+
+    fscanf(infile, "%d %d %d %d %f %f %f %f %f %f %f",
+           &initial_inv_level, &num_months, &num_policies, &num_values_demand,
+           &mean_interdemand, &setup_cost, &incremental_cost, &holding_cost,
+           &shortage_cost, &minlag, &maxlag);
+    fscanf(crnfile, "%d %d", &num_reps, &num_threads);
+    if (num_reps < 2)
+        num_reps = 2;
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads < 1)
+        num_threads = 1;
+    if (num_threads > MAX_THREADS)
+        num_threads = MAX_THREADS;
+
+    prob_distrib_demand = (float *) malloc((num_values_demand + 1) *
+                                           sizeof(float));
+    smalls = (int *) malloc(num_policies * sizeof(int));
+    bigs   = (int *) malloc(num_policies * sizeof(int));
+    caches = (demand_cache *) calloc(num_reps, sizeof(demand_cache));
+    costs  = (cost *) malloc((size_t) num_policies * num_reps * sizeof(cost));
+    if (prob_distrib_demand == NULL || smalls == NULL || bigs == NULL ||
+        caches == NULL || costs == NULL) {
+        fprintf(outfile, "\nInsufficient memory for %d policies", num_policies);
+        exit(2);
+    }
+    if (num_values_demand > 255) {
+        fprintf(outfile, "\nDemand sizes above 255 do not fit in a byte");
+        exit(2);
+    }
+    for (i = 1; i <= num_values_demand; ++i)
+        fscanf(infile, "%f", &prob_distrib_demand[i]);
+    for (i = 0; i < num_policies; ++i)
+        fscanf(infile, "%d %d", &smalls[i], &bigs[i]);
+
+    if (alias_build(&alias_demand, prob_distrib_demand, num_values_demand) < 0) {
+        fprintf(outfile, "\nCannot build the demand-size distribution");
+        exit(2);
+    }
+}
+
+
+void generate(demand_cache *c)  /* Generate the demands of a replication. */
+{
+    int   i, capacity;
+    float time;
+
+    /* Leave room for twice the expected number of demands, and grow by
+       doubling if that is not enough. */
+
+    capacity = (int) (2 * num_months / mean_interdemand) + 16;
+    c->time  = (float *) malloc(capacity * sizeof(float));
+    c->size  = (unsigned char *) malloc(capacity);
+    c->lag   = (float *) malloc((num_months + 1) * sizeof(float));
+    if (c->time == NULL || c->size == NULL || c->lag == NULL) {
+        fprintf(outfile, "\nInsufficient memory for the demands");
+        exit(2);
+    }
+
+    /* Draw the demands as inv.c does, each size then the time of the next,
+       up to the end of the simulation. */
+
+    c->num_demands = 0;
+    for (time = expon(mean_interdemand); time < num_months;
+         time += expon(mean_interdemand)) {
+        if (c->num_demands == capacity) {
+            capacity *= 2;
+            c->time = (float *) realloc(c->time, capacity * sizeof(float));
+            c->size = (unsigned char *) realloc(c->size, capacity);
+            if (c->time == NULL || c->size == NULL) {
+                fprintf(outfile, "\nInsufficient memory for the demands");
+                exit(2);
+            }
+        }
+        c->time[c->num_demands]   = time;
+        c->size[c->num_demands++] =
+            (unsigned char) alias_sample(&alias_demand, lcgrand(1));
+    }
+    for (i = 0; i <= num_months; ++i)
+        c->lag[i] = lcgrand(1);
+    num_demands_total += c->num_demands;
+}
+
+
+void *replay_thread(void *arg)  /* Replay a thread's share of the (policy,
+                                   replication) pairs. */
+{
+    long k, num_pairs = (long) num_policies * num_reps;
+
+    for (k = (long) arg; k < num_pairs; k += num_threads)
+        replay(k / num_reps, &caches[k % num_reps], &costs[k]);
+    return NULL;
+}
+
+
+void replay(int policy, const demand_cache *c, cost *out)
+    /* Run policy "policy" on the demands of a replication.  The events are
+       those of inv.c, taken in the same order: at equal times an order
+       arrival comes first, then a demand, then the end of the simulation,
+       then an evaluation. */
+{
+    int   next = 0, month = 0, inv_level = initial_inv_level, amount = 0;
+    float sim_time, time_last_event = 0.0, time_order_arrival = NEVER,
+          time_evaluation = 0.0, time_demand, area_holding = 0.0,
+          area_shortage = 0.0, total_ordering_cost = 0.0,
+          time_since_last_event;
+
+    for (;;) {
+
+        /* Determine the next event, and update the areas up to it. */
+
+        time_demand = next < c->num_demands ? c->time[next] : NEVER;
+        sim_time    = time_order_arrival;
+        if (time_demand < sim_time)
+            sim_time = time_demand;
+        if (num_months < sim_time)
+            sim_time = num_months;
+        if (time_evaluation < sim_time)
+            sim_time = time_evaluation;
+
+        time_since_last_event = sim_time - time_last_event;
+        time_last_event       = sim_time;
+        if (inv_level < 0)
+            area_shortage -= inv_level * time_since_last_event;
+        else if (inv_level > 0)
+            area_holding  += inv_level * time_since_last_event;
+
+        if (time_order_arrival == sim_time) {
+
+            /* The order arrives. */
+
+            inv_level          += amount;
+            time_order_arrival  = NEVER;
+        }
+        else if (time_demand == sim_time)
+            inv_level -= c->size[next++];
+        else if (num_months == sim_time)
+            break;
+        else {
+
+            /* Evaluate the inventory, ordering up to S if it is below s. */
+
+            if (inv_level < smalls[policy]) {
+                amount               = bigs[policy] - inv_level;
+                total_ordering_cost += setup_cost + incremental_cost * amount;
+                time_order_arrival   = sim_time + minlag +
+                                       c->lag[month] * (maxlag - minlag);
+            }
+            ++month;
+            time_evaluation = sim_time + 1.0;
+        }
+    }
+
+    out->ordering = total_ordering_cost / num_months;
+    out->holding  = holding_cost * area_holding / num_months;
+    out->shortage = shortage_cost * area_shortage / num_months;
+}
+
+
+void report(double generate_seconds, double replay_seconds)
+    /* Report generator function. */
+{
+    int    i, p, r, best = 0;
+    double sum[4], total, mean_total[num_policies], d, sum_d, sum_sq_d,
+           mean_d, var, half_width, sum_sq_total;
+    cost   *c;
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-product inventory system, common demands\n\n");
+    fprintf(outfile, "Initial inventory level%24d items\n\n",
+            initial_inv_level);
+    fprintf(outfile, "Number of demand sizes%25d\n\n", num_values_demand);
+    fprintf(outfile, "Distribution function of demand sizes  ");
+    for (i = 1; i <= num_values_demand; ++i)
+        fprintf(outfile, "%8.3f", prob_distrib_demand[i]);
+    fprintf(outfile, "\n\nMean interdemand time%26.2f\n\n", mean_interdemand);
+    fprintf(outfile, "Delivery lag range%29.2f to%10.2f months\n\n", minlag,
+            maxlag);
+    fprintf(outfile, "Length of the simulation%23d months\n\n", num_months);
+    fprintf(outfile, "K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+            setup_cost, incremental_cost, holding_cost, shortage_cost);
+    fprintf(outfile, "Number of policies%29d\n\n", num_policies);
+    fprintf(outfile, "Replications%35d\n\n", num_reps);
+
+    /* Find the policy with the least mean total cost. */
+
+    for (p = 0; p < num_policies; ++p) {
+        mean_total[p] = 0.0;
+        for (r = 0; r < num_reps; ++r) {
+            c = &costs[p * num_reps + r];
+            mean_total[p] += c->ordering + c->holding + c->shortage;
+        }
+        mean_total[p] /= num_reps;
+        if (mean_total[p] < mean_total[best])
+            best = p;
+    }
+
+    /* Write one row per policy: the mean costs, the half-width for the
+       total, and the difference from the best with its half-width over the
+       paired replications. */
+
+    fprintf(outfile, "%-9s%15s%9s%15s%15s%15s%11s\n", "", "Average", "",
+            "Average", "Average", "Average", "Difference");
+    fprintf(outfile, "%-9s%15s%9s%15s%15s%15s%11s%9s\n", "Policy",
+            "total cost", "+/-", "ordering cost", "holding cost",
+            "shortage cost", "from best", "+/-");
+    for (p = 0; p < num_policies; ++p) {
+        sum[0] = sum[1] = sum[2] = sum_sq_total = sum_d = sum_sq_d = 0.0;
+        for (r = 0; r < num_reps; ++r) {
+            c      = &costs[p * num_reps + r];
+            total  = c->ordering + c->holding + c->shortage;
+            sum[0] += c->ordering;
+            sum[1] += c->holding;
+            sum[2] += c->shortage;
+            sum_sq_total += total * total;
+            c  = &costs[best * num_reps + r];
+            d  = total - (c->ordering + c->holding + c->shortage);
+            sum_d    += d;
+            sum_sq_d += d * d;
+        }
+        var = (sum_sq_total - num_reps * mean_total[p] * mean_total[p]) /
+              (num_reps - 1);
+        half_width = t_crit(num_reps - 1) *
+                     sqrt(var > 0.0 ? var / num_reps : 0.0);
+        fprintf(outfile, "(%3d,%3d)%15.2f%9.2f%15.2f%15.2f%15.2f",
+                smalls[p], bigs[p], mean_total[p], half_width,
+                sum[0] / num_reps, sum[1] / num_reps, sum[2] / num_reps);
+        mean_d = sum_d / num_reps;
+        var    = (sum_sq_d - num_reps * mean_d * mean_d) / (num_reps - 1);
+        fprintf(outfile, "%11.2f%9.2f\n", mean_d, t_crit(num_reps - 1) *
+                sqrt(var > 0.0 ? var / num_reps : 0.0));
+    }
+
+    fprintf(outfile, "\nHalf-widths are of 95%% confidence intervals over");
+    fprintf(outfile, " the replications.\n\n");
+    fprintf(outfile, "Demands per replication%24.1f\n\n",
+            (double) num_demands_total / num_reps);
+    fprintf(outfile, "Threads%40d\n\n", num_threads);
+    fprintf(outfile, "Seconds generating demands%21.3f\n\n",
+            generate_seconds);
+    fprintf(outfile, "Seconds replaying policies%21.3f\n", replay_seconds);
+}
+
+
+double t_crit(int df)  /* t quantile (0.975) for df degrees of freedom. */
+{
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    const double z = 1.959964;
+
+    /* Beyond the table, the Cornish-Fisher expansion about the normal
+       quantile is good to three decimals. */
+
+    if (df <= 30)
+        return table[df - 1];
+    return z + (z * z * z + z) / (4.0 * df) +
+           (5 * pow(z, 5) + 16 * z * z * z + 3 * z) / (96.0 * df * df);
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(1));
+}
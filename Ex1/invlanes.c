@@ -0,0 +1,388 @@
+/* External definitions for lane-parallel replications of the inventory
+   system of inv.c.
+
+   The model runs LANES independent replications of each (s,S) policy side
+   by side.  Replication r draws all its random numbers from stream r, and
+   keeps that stream from one policy to the next, as inv.c keeps stream 1, so
+   replication r gives exactly the results of inv.c run on stream r.  In
+   particular replication 1 reproduces inv.out.
+
+   The replications share the monthly evaluations and the end of the
+   simulation, and differ only in their demands and order arrivals.  The
+   simulation therefore advances from one evaluation to the next in
+   lockstep: at each step every replication whose next demand or order
+   arrival falls before the evaluation executes it, and the others are
+   masked off.  The state of each replication is one lane of an array, and
+   the steps are written as loops over the lanes with the masks applied by
+   selection rather than by branching, so the compiler can vectorize them.
+   The random numbers are generated lane by lane with the arithmetic of
+   lcgrand, so they are the same numbers lcgrand would return. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "alias.h"    /* Header file for alias-method sampler. */
+#include "aout.h"     /* Header file for the background report writer. */
+
+#define LANES     8        /* Number of replications run side by side. */
+#define MODLUS    2147483647
+#define MULT      630360016  /* Product of the two multipliers of lcgrand. */
+#define NEVER     1.0e+30    /* Time of an event that is not scheduled. */
+
+/* Totals of one policy in every lane, for its report.  write_report reads
+   the cost parameters from the globals. */
+
+typedef struct {
+    int   smalls, bigs;
+    float total_ordering_cost[LANES], area_holding[LANES],
+          area_shortage[LANES];
+} policy_report;
+
+/* State of the replications, one lane per replication. */
+
+long  zrng[LANES];
+int   amount[LANES], inv_level[LANES], active[LANES], is_order[LANES];
+float area_holding[LANES], area_shortage[LANES], time_last_event[LANES],
+      time_next_demand[LANES], time_order_arrival[LANES],
+      time_next_event[LANES], total_ordering_cost[LANES], u[LANES];
+
+int   bigs, initial_inv_level, num_months, num_values_demand, smalls;
+float holding_cost, incremental_cost, maxlag, mean_interdemand, minlag,
+      *prob_distrib_demand, setup_cost, shortage_cost;
+alias_table alias_demand;
+FILE  *infile, *outfile;
+
+void initialize(void);
+void advance(float time_evaluation);
+void update_time_avg_stats(const int mask[]);
+void evaluate(float time);
+void report(void);
+void write_report(FILE *, const void *);
+void lanes_lcgrand(const int mask[]);
+
+
+int main()  /* Main function. */
+{
+    int i, lane, month, num_policies;
+
+    /* Open input and output files. */
+
+    infile  = fopen("inv.in",  "r");
+    outfile = fopen("invlanes.out", "w");
+
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%d %d %d %d %f %f %f %f %f %f %f",
+           &initial_inv_level, &num_months, &num_policies, &num_values_demand,
+           &mean_interdemand, &setup_cost, &incremental_cost, &holding_cost,
+           &shortage_cost, &minlag, &maxlag);
+    prob_distrib_demand = (float *) malloc((num_values_demand + 1) *
+                                           sizeof(float));
+    if (prob_distrib_demand == NULL) {
+        aout_printf("\nInsufficient memory for %d demand sizes",
+                    num_values_demand);
+        exit(2);
+    }
+    for (i = 1; i <= num_values_demand; ++i)
+        fscanf(infile, "%f", &prob_distrib_demand[i]);
+    if (alias_build(&alias_demand, prob_distrib_demand, num_values_demand) < 0) {
+        aout_printf("\nCannot build the demand-size distribution");
+        exit(2);
+    }
+
+    /* Start replication r at the seed of stream r.  The lanes step the
+       legacy generator, so no other has a seed to start them from. */
+
+    for (lane = 0; lane < LANES; ++lane)
+        if ((zrng[lane] = lcgrandgt(lane + 1)) < 0) {
+            aout_printf("\nThe lanes need the legacy generator");
+            exit(2);
+        }
+
+    /* Write report heading and input parameters. */
+
+    aout_printf("Single-product inventory system (%d replications in"
+                " lockstep)\n\n", LANES);
+    aout_printf("Initial inventory level%24d items\n\n",
+                initial_inv_level);
+    aout_printf("Number of demand sizes%25d\n\n", num_values_demand);
+    aout_printf("Distribution function of demand sizes  ");
+    for (i = 1; i <= num_values_demand; ++i)
+        aout_printf("%8.3f", prob_distrib_demand[i]);
+    aout_printf("\n\nMean interdemand time%26.2f\n\n", mean_interdemand);
+    aout_printf("Delivery lag range%29.2f to%10.2f months\n\n", minlag,
+                maxlag);
+    aout_printf("Length of the simulation%23d months\n\n", num_months);
+    aout_printf("K =%6.1f   i =%6.1f   h =%6.1f   pi =%6.1f\n\n",
+                setup_cost, incremental_cost, holding_cost, shortage_cost);
+    aout_printf("Number of policies%29d\n\n", num_policies);
+    aout_printf("Average total cost by replication (stream)\n\n");
+    aout_printf("  Policy ");
+    for (lane = 0; lane < LANES; ++lane)
+        aout_printf("%8d ", lane + 1);
+    aout_printf("     Mean");
+
+    /* Run the simulation varying the inventory policy. */
+
+    for (i = 1; i <= num_policies; ++i) {
+
+        /* Read the inventory policy, and initialize the simulation. */
+
+        fscanf(infile, "%d %d", &smalls, &bigs);
+        initialize();
+
+        /* Evaluate the inventory at the start of each month, and advance all
+           replications to the next evaluation.  The end of the simulation
+           comes before the evaluation at the same time, as in inv.c. */
+
+        for (month = 0; month < num_months; ++month) {
+            evaluate((float) month);
+            advance((float) (month + 1));
+        }
+
+        /* Invoke the report generator for the current (s,S) pair. */
+
+        report();
+    }
+
+    /* End the simulations. */
+
+    alias_free(&alias_demand);
+    free(prob_distrib_demand);
+    fclose(infile);
+    aout_close();
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int lane, all[LANES];
+
+    /* Initialize the state variables and the statistical counters of every
+       replication.  Since no order is outstanding, the order-arrival events
+       are eliminated from consideration. */
+
+    for (lane = 0; lane < LANES; ++lane) {
+        inv_level[lane]           = initial_inv_level;
+        time_last_event[lane]     = 0.0;
+        total_ordering_cost[lane] = 0.0;
+        area_holding[lane]        = 0.0;
+        area_shortage[lane]       = 0.0;
+        time_order_arrival[lane]  = NEVER;
+        all[lane]                 = 1;
+    }
+
+    /* Schedule the first demand of every replication. */
+
+    lanes_lcgrand(all);
+    for (lane = 0; lane < LANES; ++lane)
+        time_next_demand[lane] = 0.0f +
+                                 (float) (-mean_interdemand * log(u[lane]));
+}
+
+
+void advance(float time_evaluation)  /* Advance every replication through
+                                        its demands and order arrivals up to
+                                        the next evaluation. */
+{
+    int lane, any, demand[LANES];
+
+    for (;;) {
+
+        /* Determine the next event of each replication.  An order arrival
+           comes before a demand at the same time, and both come before an
+           evaluation or the end of the simulation at the same time. */
+
+        any = 0;
+        for (lane = 0; lane < LANES; ++lane) {
+            is_order[lane]        = time_order_arrival[lane] <=
+                                    time_next_demand[lane];
+            time_next_event[lane] = is_order[lane] ? time_order_arrival[lane]
+                                                   : time_next_demand[lane];
+            active[lane]          = time_next_event[lane] <= time_evaluation;
+            demand[lane]          = active[lane] & !is_order[lane];
+            any                  |= active[lane];
+        }
+        if (!any)
+            return;
+
+        /* Update the areas of the active replications. */
+
+        update_time_avg_stats(active);
+
+        /* Order arrival: increment the inventory level by the amount
+           ordered, and eliminate the order-arrival event. */
+
+        for (lane = 0; lane < LANES; ++lane) {
+            int arrive = active[lane] & is_order[lane];
+
+            inv_level[lane]          += arrive * amount[lane];
+            time_order_arrival[lane]  = arrive ? NEVER
+                                               : time_order_arrival[lane];
+        }
+
+        /* Demand: decrement the inventory level by a generated demand size,
+           and schedule the next demand.  The size is drawn before the time,
+           as in inv.c. */
+
+        lanes_lcgrand(demand);
+        for (lane = 0; lane < LANES; ++lane)
+            if (demand[lane])
+                inv_level[lane] -= alias_sample(&alias_demand, u[lane]);
+        lanes_lcgrand(demand);
+        for (lane = 0; lane < LANES; ++lane)
+            if (demand[lane])
+                time_next_demand[lane] = time_next_event[lane] +
+                    (float) (-mean_interdemand * log(u[lane]));
+    }
+}
+
+
+void update_time_avg_stats(const int mask[])  /* Update area accumulators
+                                                 for time-average statistics
+                                                 in the lanes of mask. */
+{
+    int   lane;
+    float time_since_last_event;
+
+    /* Compute time since last event, update last-event-time marker, and
+       charge the interval to area_shortage or area_holding by the sign of
+       the inventory level. */
+
+    for (lane = 0; lane < LANES; ++lane) {
+        time_since_last_event = mask[lane]
+                                ? time_next_event[lane] - time_last_event[lane]
+                                : 0.0f;
+        time_last_event[lane] = mask[lane] ? time_next_event[lane]
+                                           : time_last_event[lane];
+        area_shortage[lane]  -= inv_level[lane] < 0
+                                ? inv_level[lane] * time_since_last_event
+                                : 0.0f;
+        area_holding[lane]   += inv_level[lane] > 0
+                                ? inv_level[lane] * time_since_last_event
+                                : 0.0f;
+    }
+}
+
+
+void evaluate(float time)  /* Inventory-evaluation function. */
+{
+    int lane, order[LANES], all[LANES];
+
+    /* Bring the areas of every replication up to the evaluation. */
+
+    for (lane = 0; lane < LANES; ++lane) {
+        time_next_event[lane] = time;
+        all[lane]             = 1;
+    }
+    update_time_avg_stats(all);
+
+    /* Place an order for S - I in every replication whose inventory level is
+       less than smalls. */
+
+    for (lane = 0; lane < LANES; ++lane) {
+        order[lane]                = inv_level[lane] < smalls;
+        amount[lane]               = order[lane] ? bigs - inv_level[lane]
+                                                 : amount[lane];
+        total_ordering_cost[lane] += order[lane]
+                                     ? setup_cost +
+                                       incremental_cost * amount[lane]
+                                     : 0.0f;
+    }
+
+    /* Schedule the arrival of the orders. */
+
+    lanes_lcgrand(order);
+    for (lane = 0; lane < LANES; ++lane)
+        time_order_arrival[lane] = order[lane]
+                                   ? time + (minlag + u[lane] *
+                                             (maxlag - minlag))
+                                   : time_order_arrival[lane];
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    policy_report r;
+    int           lane, all[LANES];
+
+    /* Bring the areas of every replication up to the end of the
+       simulation. */
+
+    for (lane = 0; lane < LANES; ++lane) {
+        time_next_event[lane] = num_months;
+        all[lane]             = 1;
+    }
+    update_time_avg_stats(all);
+
+    /* Hand a copy of the totals to the writer. */
+
+    r.smalls = smalls;
+    r.bigs   = bigs;
+    for (lane = 0; lane < LANES; ++lane) {
+        r.total_ordering_cost[lane] = total_ordering_cost[lane];
+        r.area_holding[lane]        = area_holding[lane];
+        r.area_shortage[lane]       = area_shortage[lane];
+    }
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     costs of a policy, on
+                                                     the writer thread. */
+{
+    const policy_report *r = record;
+    int    lane;
+    float  avg_holding_cost, avg_ordering_cost, avg_shortage_cost,
+           avg_total_cost[LANES];
+    double sum = 0.0;
+
+    /* Compute the average costs of each replication as inv.c does, and write
+       the total cost of each replication and the mean over them. */
+
+    for (lane = 0; lane < LANES; ++lane) {
+        avg_ordering_cost    = r->total_ordering_cost[lane] / num_months;
+        avg_holding_cost     = holding_cost * r->area_holding[lane] /
+                               num_months;
+        avg_shortage_cost    = shortage_cost * r->area_shortage[lane] /
+                               num_months;
+        avg_total_cost[lane] = avg_ordering_cost + avg_holding_cost +
+                               avg_shortage_cost;
+        sum                 += avg_total_cost[lane];
+    }
+
+    fprintf(out, "\n\n(%3d,%3d)", r->smalls, r->bigs);
+    for (lane = 0; lane < LANES; ++lane)
+        fprintf(out, "%9.2f", avg_total_cost[lane]);
+    fprintf(out, "%9.2f", sum / LANES);
+}
+
+
+void lanes_lcgrand(const int mask[])  /* Lane-wise random-number
+                                         generation. */
+{
+    int                lane;
+    unsigned long long z;
+
+    /* Advance the stream of each lane in mask by one step of lcgrand, and
+       leave the U(0,1) random number in u.  lcgrand multiplies by MULT1 and
+       MULT2 in turn, modulo MODLUS; this is the single multiplication by
+       their product, reduced with the identity 2^31 = 1 (mod MODLUS). */
+
+    for (lane = 0; lane < LANES; ++lane) {
+        z           = (unsigned long long) zrng[lane] * MULT;
+        z           = (z & MODLUS) + (z >> 31);
+        z           = z >= MODLUS ? z - MODLUS : z;
+        zrng[lane]  = mask[lane] ? (long) z : zrng[lane];
+        u[lane]     = (zrng[lane] >> 7 | 1) / 16777216.0;
+    }
+}
@@ -0,0 +1,464 @@
+/* External definitions for multi-product inventory system.
+
+   The model extends inv.c to many products (SKUs) reviewed together at the
+   start of every month.  Each SKU has its own (s,S) policy, cost parameters,
+   demand rate and demand-size distribution, and runs its own demand and
+   order-arrival events between reviews, exactly as the single product of
+   inv.c does.  The SKUs are coupled only at the reviews:
+
+   - a joint setup cost is charged once for every review at which any SKU
+     orders, on top of the setup cost of each SKU that orders, and
+
+   - when capacity is positive, the total amount ordered at one review may
+     not exceed it, so the orders are scaled down in proportion until it
+     does.
+
+   A SKU with an order outstanding at a review does not order again, so
+   delivery lags may run past the next review.
+
+   Per-SKU state is kept in contiguous arrays, one array per variable, so the
+   review is a pass over the arrays with no branches that the compiler can
+   vectorize.  The SKUs are read as classes of identical SKUs, each with a
+   count, and the demand-size distribution is kept once per class. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "alias.h"    /* Header file for alias-method sampler. */
+
+#define NEVER 1.0e+30  /* Time of an event that is not scheduled. */
+
+/* Per-SKU state and parameters, one array per variable. */
+
+int   *sku_class, *smalls, *bigs, *inv_level, *amount, *order_amount;
+float *mean_interdemand, *setup_cost, *incremental_cost, *holding_cost,
+      *shortage_cost, *time_next_demand, *time_order_arrival,
+      *time_last_event, *area_holding, *area_shortage, *total_ordering_cost;
+
+/* Per-class parameters. */
+
+int         *class_size, *class_initial_inv_level;
+alias_table *class_demand;
+
+int   capacity, num_classes, num_months, num_reviews_joint, num_reviews_capped,
+      num_skus;
+long  num_events;
+float joint_setup_cost, maxlag, minlag, total_joint_cost;
+FILE  *infile, *outfile;
+
+void  read_input(void);
+void  initialize(void);
+void  review(float time);
+void  advance(int sku, float time_end);
+void  update_time_avg_stats(int sku, float time);
+void  report(void);
+void  free_arrays(void);
+float expon(float mean);
+float uniform(float a, float b);
+
+
+int main()  /* Main function. */
+{
+    int month, sku;
+
+    /* Open input and output files. */
+
+    infile  = fopen("invmulti.in",  "r");
+    outfile = fopen("invmulti.out", "w");
+
+    /* Read input parameters, and allocate the per-SKU arrays. */
+
+    read_input();
+
+    /* Initialize the simulation. */
+
+    initialize();
+
+    /* Review all SKUs at the start of each month, then run each SKU's demands
+       and order arrivals up to the next review. */
+
+    for (month = 0; month < num_months; ++month) {
+        review((float) month);
+        for (sku = 0; sku < num_skus; ++sku)
+            advance(sku, (float) (month + 1));
+    }
+
+    /* Invoke the report generator and end the simulation. */
+
+    report();
+
+    free_arrays();
+    fclose(infile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void read_input(void)  /* Input function. */
+{
+    int   c, i, j, num_values_demand, first_sku, smalls_c, bigs_c;
+    float mean_interdemand_c, setup_cost_c, incremental_cost_c, holding_cost_c,
+          shortage_cost_c, *prob_distrib_demand;
+
+    fscanf(infile, "%d %d %d %f %f %f", &num_months, &num_classes, &capacity,
+           &joint_setup_cost, &minlag, &maxlag);
+
+    class_size              = (int *) malloc(num_classes * sizeof(int));
+    class_initial_inv_level = (int *) malloc(num_classes * sizeof(int));
+    class_demand = (alias_table *) malloc(num_classes * sizeof(alias_table));
+
+    /* Write report heading and common input parameters. */
+
+    fprintf(outfile, "Multi-product inventory system\n\n");
+    fprintf(outfile, "Number of classes%30d\n\n", num_classes);
+    fprintf(outfile, "Delivery lag range%29.2f to%10.2f months\n\n", minlag,
+            maxlag);
+    fprintf(outfile, "Length of the simulation%23d months\n\n", num_months);
+    fprintf(outfile, "Joint setup cost%31.1f\n\n", joint_setup_cost);
+    if (capacity > 0)
+        fprintf(outfile, "Capacity per review%28d items\n\n", capacity);
+    else
+        fprintf(outfile, "Capacity per review%28s\n\n", "none");
+
+    /* Read the classes, growing the per-SKU arrays by each class in turn. */
+
+    num_skus = 0;
+    for (c = 0; c < num_classes; ++c) {
+        fscanf(infile, "%d %d %d %d %f %f %f %f %f %d", &class_size[c],
+               &smalls_c, &bigs_c, &class_initial_inv_level[c],
+               &mean_interdemand_c, &setup_cost_c, &incremental_cost_c,
+               &holding_cost_c, &shortage_cost_c, &num_values_demand);
+        prob_distrib_demand = (float *) malloc((num_values_demand + 1) *
+                                               sizeof(float));
+        for (i = 1; i <= num_values_demand; ++i)
+            fscanf(infile, "%f", &prob_distrib_demand[i]);
+        if (alias_build(&class_demand[c], prob_distrib_demand,
+                        num_values_demand) < 0) {
+            fprintf(outfile, "\nCannot build the demand-size distribution"
+                    " of class %d", c + 1);
+            exit(2);
+        }
+        free(prob_distrib_demand);
+
+        fprintf(outfile, "Class %d:%5d SKUs   (s,S) = (%3d,%3d)   "
+                "mean interdemand%6.2f\n", c + 1, class_size[c], smalls_c,
+                bigs_c, mean_interdemand_c);
+        fprintf(outfile, "         K =%6.1f   i =%6.1f   h =%6.1f   "
+                "pi =%6.1f\n\n", setup_cost_c, incremental_cost_c,
+                holding_cost_c, shortage_cost_c);
+
+        first_sku  = num_skus;
+        num_skus  += class_size[c];
+
+        sku_class          = (int *) realloc(sku_class, num_skus * sizeof(int));
+        smalls             = (int *) realloc(smalls, num_skus * sizeof(int));
+        bigs               = (int *) realloc(bigs, num_skus * sizeof(int));
+        mean_interdemand   = (float *) realloc(mean_interdemand,
+                                               num_skus * sizeof(float));
+        setup_cost         = (float *) realloc(setup_cost,
+                                               num_skus * sizeof(float));
+        incremental_cost   = (float *) realloc(incremental_cost,
+                                               num_skus * sizeof(float));
+        holding_cost       = (float *) realloc(holding_cost,
+                                               num_skus * sizeof(float));
+        shortage_cost      = (float *) realloc(shortage_cost,
+                                               num_skus * sizeof(float));
+        if (sku_class == NULL || smalls == NULL || bigs == NULL ||
+            mean_interdemand == NULL || setup_cost == NULL ||
+            incremental_cost == NULL || holding_cost == NULL ||
+            shortage_cost == NULL) {
+            fprintf(outfile, "\nInsufficient memory for %d SKUs", num_skus);
+            exit(2);
+        }
+
+        for (j = first_sku; j < num_skus; ++j) {
+            sku_class[j]        = c;
+            smalls[j]           = smalls_c;
+            bigs[j]             = bigs_c;
+            mean_interdemand[j] = mean_interdemand_c;
+            setup_cost[j]       = setup_cost_c;
+            incremental_cost[j] = incremental_cost_c;
+            holding_cost[j]     = holding_cost_c;
+            shortage_cost[j]    = shortage_cost_c;
+        }
+    }
+
+    /* Allocate the state arrays. */
+
+    inv_level           = (int *) malloc(num_skus * sizeof(int));
+    amount              = (int *) malloc(num_skus * sizeof(int));
+    order_amount        = (int *) malloc(num_skus * sizeof(int));
+    time_next_demand    = (float *) malloc(num_skus * sizeof(float));
+    time_order_arrival  = (float *) malloc(num_skus * sizeof(float));
+    time_last_event     = (float *) malloc(num_skus * sizeof(float));
+    area_holding        = (float *) malloc(num_skus * sizeof(float));
+    area_shortage       = (float *) malloc(num_skus * sizeof(float));
+    total_ordering_cost = (float *) malloc(num_skus * sizeof(float));
+    if (inv_level == NULL || amount == NULL || order_amount == NULL ||
+        time_next_demand == NULL || time_order_arrival == NULL ||
+        time_last_event == NULL || area_holding == NULL ||
+        area_shortage == NULL || total_ordering_cost == NULL) {
+        fprintf(outfile, "\nInsufficient memory for %d SKUs", num_skus);
+        exit(2);
+    }
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int sku;
+
+    /* Initialize the state variables, the statistical counters and the
+       events of each SKU.  Since no order is outstanding, the order-arrival
+       events are eliminated from consideration. */
+
+    for (sku = 0; sku < num_skus; ++sku) {
+        inv_level[sku]           = class_initial_inv_level[sku_class[sku]];
+        amount[sku]              = 0;
+        time_last_event[sku]     = 0.0;
+        area_holding[sku]        = 0.0;
+        area_shortage[sku]       = 0.0;
+        total_ordering_cost[sku] = 0.0;
+        time_order_arrival[sku]  = NEVER;
+        time_next_demand[sku]    = expon(mean_interdemand[sku]);
+    }
+
+    num_events         = 0;
+    num_reviews_joint  = 0;
+    num_reviews_capped = 0;
+    total_joint_cost   = 0.0;
+}
+
+
+void review(float time)  /* Review function for all SKUs. */
+{
+    /* The arrays and the SKU count are copied into locals declared restrict,
+       so the compiler knows the stores to order_amount and
+       total_ordering_cost do not change them, and can vectorize the loops.
+       The orders are built in order_amount, since amount still holds the
+       orders outstanding. */
+
+    const int   *restrict inv = inv_level, *restrict s = smalls,
+                *restrict S = bigs;
+    const float *restrict k = setup_cost, *restrict i = incremental_cost,
+                *restrict arrival = time_order_arrival;
+    int         *restrict z = order_amount;
+    float       *restrict cost = total_ordering_cost;
+    int       n = num_skus, sku, total_amount, num_ordering;
+    long long running, given, next;
+
+    /* Determine the amount each SKU orders: S - I below s, unless an order is
+       outstanding, else nothing.  The SKUs are independent here, so the loop
+       has no branches. */
+
+    total_amount = 0;
+    num_ordering = 0;
+    for (sku = 0; sku < n; ++sku) {
+        int order     = (inv[sku] < s[sku]) & (arrival[sku] == (float) NEVER);
+        z[sku]        = order * (S[sku] - inv[sku]);
+        total_amount += z[sku];
+        num_ordering += order;
+    }
+
+    if (num_ordering == 0)
+        return;
+
+    /* Scale the orders down in proportion if they exceed the capacity.  Each
+       share is the difference of the running totals scaled and rounded down,
+       so it is within a unit of its proportion and the shares add up to the
+       capacity. */
+
+    if (capacity > 0 && total_amount > capacity) {
+        running = 0;
+        given   = 0;
+        for (sku = 0; sku < n; ++sku) {
+            running += z[sku];
+            next     = running * capacity / total_amount;
+            z[sku]   = (int) (next - given);
+            given    = next;
+        }
+        ++num_reviews_capped;
+    }
+
+    /* Charge the ordering costs.  A SKU whose order was scaled down to
+       nothing does not order. */
+
+    for (sku = 0; sku < n; ++sku)
+        cost[sku] += (z[sku] > 0) * k[sku] + i[sku] * z[sku];
+    total_joint_cost += joint_setup_cost;
+    ++num_reviews_joint;
+
+    /* Record the orders and schedule their arrivals.  The delivery lags are
+       drawn in SKU order, which is the one part of the review left scalar. */
+
+    for (sku = 0; sku < num_skus; ++sku)
+        if (order_amount[sku] > 0) {
+            amount[sku]             = order_amount[sku];
+            time_order_arrival[sku] = time + uniform(minlag, maxlag);
+        }
+}
+
+
+void advance(int sku, float time_end)  /* Run one SKU's demands and order
+                                          arrival up to time_end. */
+{
+    const alias_table *demand = &class_demand[sku_class[sku]];
+
+    for (;;) {
+
+        /* Determine the next event of this SKU.  As in inv.c, an order
+           arrival comes before a demand at the same time. */
+
+        if (time_order_arrival[sku] <= time_next_demand[sku]) {
+            if (time_order_arrival[sku] >= time_end)
+                break;
+
+            /* Order arrival: increment the inventory level by the amount
+               ordered. */
+
+            update_time_avg_stats(sku, time_order_arrival[sku]);
+            inv_level[sku]          += amount[sku];
+            time_order_arrival[sku]  = NEVER;
+        }
+        else {
+            if (time_next_demand[sku] >= time_end)
+                break;
+
+            /* Demand: decrement the inventory level by a generated demand
+               size, and schedule the next demand. */
+
+            update_time_avg_stats(sku, time_next_demand[sku]);
+            inv_level[sku]        -= alias_sample(demand, lcgrand(1));
+            time_next_demand[sku]  = time_last_event[sku] +
+                                     expon(mean_interdemand[sku]);
+        }
+        ++num_events;
+    }
+
+    /* Bring the areas up to the next review. */
+
+    update_time_avg_stats(sku, time_end);
+}
+
+
+void update_time_avg_stats(int sku, float time)  /* Update area accumulators
+                                                    for time-average
+                                                    statistics. */
+{
+    float time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = time - time_last_event[sku];
+    time_last_event[sku]  = time;
+
+    /* If the inventory level during the previous interval was negative, update
+       area_shortage.  If it was positive, update area_holding. */
+
+    if (inv_level[sku] < 0)
+        area_shortage[sku] -= inv_level[sku] * time_since_last_event;
+    else if (inv_level[sku] > 0)
+        area_holding[sku]  += inv_level[sku] * time_since_last_event;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    int    c, sku;
+    double *ordering, *holding, *shortage, total_ordering = 0.0,
+           total_holding = 0.0, total_shortage = 0.0;
+
+    /* Sum the costs of the SKUs in each class. */
+
+    ordering = (double *) calloc(num_classes, sizeof(double));
+    holding  = (double *) calloc(num_classes, sizeof(double));
+    shortage = (double *) calloc(num_classes, sizeof(double));
+
+    for (sku = 0; sku < num_skus; ++sku) {
+        c            = sku_class[sku];
+        ordering[c] += total_ordering_cost[sku];
+        holding[c]  += holding_cost[sku] * area_holding[sku];
+        shortage[c] += shortage_cost[sku] * area_shortage[sku];
+    }
+
+    /* Write the average monthly costs per SKU of each class. */
+
+    fprintf(outfile, "Average monthly costs per SKU\n\n");
+    fprintf(outfile, "                 Average        Average");
+    fprintf(outfile, "        Average        Average\n");
+    fprintf(outfile, "   Class       total cost    ordering cost");
+    fprintf(outfile, "  holding cost   shortage cost\n");
+    for (c = 0; c < num_classes; ++c) {
+        double scale = 1.0 / ((double) class_size[c] * num_months);
+
+        fprintf(outfile, "\n%6d%17.2f%15.2f%15.2f%15.2f\n", c + 1,
+                (ordering[c] + holding[c] + shortage[c]) * scale,
+                ordering[c] * scale, holding[c] * scale, shortage[c] * scale);
+        total_ordering += ordering[c];
+        total_holding  += holding[c];
+        total_shortage += shortage[c];
+    }
+
+    /* Write the monthly totals over all SKUs, and the joint costs. */
+
+    fprintf(outfile, "\nAverage monthly cost of all SKUs%15.2f\n\n",
+            (total_ordering + total_holding + total_shortage +
+             total_joint_cost) / num_months);
+    fprintf(outfile, "Average monthly joint setup cost%15.2f\n\n",
+            total_joint_cost / num_months);
+    fprintf(outfile, "Reviews with an order%26d\n\n", num_reviews_joint);
+    fprintf(outfile, "Reviews at capacity%28d\n\n", num_reviews_capped);
+    fprintf(outfile, "Events processed%31ld\n", num_events);
+
+    free(ordering);
+    free(holding);
+    free(shortage);
+}
+
+
+void free_arrays(void)  /* Release the per-SKU and per-class arrays. */
+{
+    int c;
+
+    for (c = 0; c < num_classes; ++c)
+        alias_free(&class_demand[c]);
+    free(class_demand);
+    free(class_size);
+    free(class_initial_inv_level);
+    free(sku_class);
+    free(smalls);
+    free(bigs);
+    free(mean_interdemand);
+    free(setup_cost);
+    free(incremental_cost);
+    free(holding_cost);
+    free(shortage_cost);
+    free(inv_level);
+    free(amount);
+    free(order_amount);
+    free(time_next_demand);
+    free(time_order_arrival);
+    free(time_last_event);
+    free(area_holding);
+    free(area_shortage);
+    free(total_ordering_cost);
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(1));
+}
+
+
+float uniform(float a, float b)  /* Uniform variate generation function. */
+{
+    /* Return a U(a,b) random variate.  Delivery lags come from their own
+       stream, so a change in ordering does not shift the demands. */
+
+    return a + lcgrand(2) * (b - a);
+}
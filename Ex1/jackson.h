@@ -0,0 +1,26 @@
+#ifndef _JACKSON_H
+#define _JACKSON_H
+
+/*
+ * The following declarations are used for the exact steady-state measures
+ * of a product-form tandem line: Poisson arrivals, single exponential
+ * servers with unlimited queues, and optionally infinite-server delay
+ * (transit) nodes between them.  By Burke's theorem each station then sees
+ * Poisson arrivals at the external rate and behaves as an M/M/1 queue, and
+ * an infinite-server node is insensitive to its delay distribution.
+ */
+
+typedef struct {
+    int    stable;                // 1 if the station has a steady state.
+    double utilization;
+    double avg_num_in_queue;
+    double avg_delay_in_queue;    // Same time units as the input means.
+    double avg_num_in_system;
+    double avg_time_in_system;
+} jackson_station;
+
+int    jackson_tandem(float mean_interarrival, const float mean_service[],
+                      int num_stations, jackson_station result[]);
+double jackson_delay_node(float mean_interarrival, float mean_delay);
+
+#endif // _JACKSON_H
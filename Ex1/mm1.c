@@ -3,20 +3,60 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
+#include "evsel.h"    /* Header file for next-event selector. */
+#include "jackson.h"  /* Header file for product-form steady state. */
+#include "aout.h"     /* Header file for the background report writer. */
 
 #define Q_LIMIT 10000  /* Limit on queue length. */
 #define BUSY        1  /* Mnemonics for server's being busy */
 #define IDLE        0  /* and idle. */
+#define REPS       10  /* Number of runs for the simulation. */
+#define MEASURES    6  /* Number of measures in the cross-check. */
+#define T_CRIT  2.262  /* t quantile (0.975) for REPS - 1 degrees of freedom. */
+#define PARAMS      3  /* Inputs with gradients: the mean interarrival time
+                          and the two mean service times. */
+#define GRADIENTS   6  /* Number of measures with gradients. */
+
+/* Counters and areas of one run, for its report. */
+
+typedef struct {
+    int   num_custs_delayed[2];
+    float total_of_delays[2], area_num_in_[2], area_server_status[2],
+          sim_time;
+} run_report;
 
 int   next_event_type, num_custs_delayed[2],
       num_time_max, num_events,
-      num_in_[2], server_status[2];
+      num_in_[2], server_status[2], analytic, cross_check, gradients,
+      uniformized, head_ctmc[2];
 float area_num_in_[2], area_server_status[2],
       mean_interarrival, mean_service[2],
       sim_time, time_arrival[Q_LIMIT + 1], time_transfer[Q_LIMIT + 1],
-      time_last_event[2], time_next_event[4],
-      total_of_delays[2];
+      time_last_event[2], total_of_delays[2];
+double sum_measure[MEASURES], sum_sq_measure[MEASURES];
+
+/* Derivatives, for the gradients, with respect to each of the PARAMS
+   inputs: of the time of the next arrival, of the arrival time of each
+   customer in queue, of the departure time of the customer in service, and
+   of the totals of delays and of service times.  The arrival times of the
+   customers in queue are kept again alongside their derivatives, with the
+   totals they give. */
+
+float  time_last_arrival, time_queue_ipa[2][Q_LIMIT + 1];
+double d_next_arrival[PARAMS], d_queue[2][Q_LIMIT + 1][PARAMS],
+       d_depart[2][PARAMS], d_total_of_delays[2][PARAMS],
+       d_total_of_service[2][PARAMS], d_customer[PARAMS],
+       d_last_arrival[PARAMS], num_starts_ipa[2], total_of_delays_ipa[2],
+       total_of_service_ipa[2],
+       sum_gradient[GRADIENTS][PARAMS], sum_sq_gradient[GRADIENTS][PARAMS];
+
+/* Arrival times of the customers in each queue, in a ring from head_ctmc,
+   and the total of delays, in the uniformized chain. */
+
+double time_queue_ctmc[2][Q_LIMIT + 1], total_of_delays_ctmc[2];
+_Alignas(EVSEL_ALIGN) float time_next_event[EVSEL_SIZE(3)];
 FILE  *infile, *outfile;
 
 void  initialize(void);
@@ -25,17 +65,66 @@ void  arrive(void);
 void  transfer(void);
 void  depart(void);
 void  report(void);
+void  write_report(FILE *, const void *);
 void  update_time_avg_stats(int);
+int   report_analytic(void);
+void  record_measures(void);
+void  report_cross_check(void);
+void  schedule_arrival(void);
+void  ipa_start(int, const double[], const double[], float, float);
+void  report_gradients(void);
+void  report_gradient_summary(void);
+void  simulate_uniformized(void);
+void  enter_ctmc(int, double);
+void  leave_ctmc(int, double);
 float expon(float mean);
 
 
-int main()  /* Main function. */
+int main(int argc, char *argv[])  /* Main function. */
 {
+    /* Check for the options -a (answer product-form inputs analytically),
+       -c (cross-check the simulation against the analytic values),
+       -r name (draw the random numbers from the named generator),
+       -g (estimate gradients by infinitesimal perturbation analysis) and
+       -u (simulate the system as a uniformized Markov chain). */
+
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 == argc) {
+            fprintf(stderr, "Usage: mm1 [-a] [-c] [-r name] [-g] [-u]\n");
+            exit(1);
+        }
+        if (strcmp(argv[i], "-a") == 0)
+            analytic = 1;
+        else if (strcmp(argv[i], "-c") == 0)
+            cross_check = 1;
+        else if (strcmp(argv[i], "-r") == 0) {
+            if (lcgrandbk(lcgrandid(argv[++i])) < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i], "-g") == 0)
+            gradients = 1;
+        else if (strcmp(argv[i], "-u") == 0)
+            uniformized = 1;
+    }
+    if (gradients && uniformized) {
+        fprintf(stderr, "Gradients need the service times of the event"
+                " simulation\n");
+        exit(1);
+    }
+
     /* Open input and output files. */
 
     infile  = fopen("mm1.in",  "r");
     outfile = fopen("mm1.out", "w");
 
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
     /* Specify the number of events for the timing function. */
 
     num_events = 3;
@@ -47,23 +136,40 @@ int main()  /* Main function. */
 
     /* Write report heading and input parameters. */
 
-    fprintf(outfile, "Tandem-server queueing system\n\n");
-    fprintf(outfile, "Mean interarrival time%16.3f minutes\n\n",
-            mean_interarrival);
-    fprintf(outfile, "Mean service time (server 1)%10.3f minutes\n\n",
-            mean_service[0]);
-    fprintf(outfile, "Mean service time (server 2)%10.3f minutes\n\n",
-            mean_service[1]);
-    fprintf(outfile, "Time cutoff%27d minutes\n\n", num_time_max);
+    aout_printf("Tandem-server queueing system\n\n");
+    aout_printf("Mean interarrival time%16.3f minutes\n\n",
+                mean_interarrival);
+    aout_printf("Mean service time (server 1)%10.3f minutes\n\n",
+                mean_service[0]);
+    aout_printf("Mean service time (server 2)%10.3f minutes\n\n",
+                mean_service[1]);
+    aout_printf("Time cutoff%27d minutes\n\n", num_time_max);
+    if (uniformized)
+        aout_printf("Simulated as a uniformized Markov chain\n\n");
+
+    /* Inputs with a product-form steady state need no simulation in
+       analytic mode. */
+
+    if (analytic && !gradients && report_analytic()) {
+        fclose(infile);
+        aout_close();
+        fclose(outfile);
+        return 0;
+    }
 
     /* Loop body starts */
-    int i = 0;
-    for (; i < 10; i++){
+    for (i = 0; i < REPS; i++){
 
         /* Initialize the simulation. */
 
         initialize();
 
+        /* The uniformized chain runs to the cutoff on its own, leaving the
+           event loop nothing to do. */
+
+        if (uniformized)
+            simulate_uniformized();
+
         /* Run the simulation while more delays are still needed. */
 
         while (sim_time < num_time_max)
@@ -91,11 +197,21 @@ int main()  /* Main function. */
         /* Invoke the report generator and end the simulation. */
 
         report();
+        if (cross_check)
+            record_measures();
+        if (gradients)
+            report_gradients();
 
     }
     /* End loop body */
 
+    if (cross_check)
+        report_cross_check();
+    if (gradients)
+        report_gradient_summary();
+
     fclose(infile);
+    aout_close();
     fclose(outfile);
 
     return 0;
@@ -126,10 +242,26 @@ void initialize(void)  /* Initialization function. */
     area_server_status[0] = 0.0;
     area_server_status[1] = 0.0;
 
+    /* Initialize the derivatives. */
+
+    if (gradients) {
+        memset(d_next_arrival, 0, sizeof(d_next_arrival));
+        memset(d_depart, 0, sizeof(d_depart));
+        memset(d_total_of_delays, 0, sizeof(d_total_of_delays));
+        memset(d_total_of_service, 0, sizeof(d_total_of_service));
+        memset(num_starts_ipa, 0, sizeof(num_starts_ipa));
+        memset(total_of_delays_ipa, 0, sizeof(total_of_delays_ipa));
+        memset(total_of_service_ipa, 0, sizeof(total_of_service_ipa));
+    }
+
+    /* Pad the event list for the next-event selector. */
+
+    evsel_pad(time_next_event, num_events);
+
     /* Initialize event list.  Since no customers are present, the departure
        (service completion) event is eliminated from consideration. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    schedule_arrival();
     time_next_event[2] = 1.0e+30;
     time_next_event[3] = 1.0e+30;
 }
@@ -137,19 +269,12 @@ void initialize(void)  /* Initialization function. */
 
 void timing(void)  /* Timing function. */
 {
-    int   i;
-    float min_time_next_event = 1.0e+29;
-
-    next_event_type = 0;
+    float min_time_next_event;
 
     /* Determine the event type of the next event to occur. */
 
-    for (i = 1; i <= num_events; ++i)
-        if (time_next_event[i] < min_time_next_event)
-        {
-            min_time_next_event = time_next_event[i];
-            next_event_type     = i;
-        }
+    next_event_type = evsel_next(time_next_event, num_events,
+                                 &min_time_next_event);
 
     /* Check to see whether the event list is empty. */
 
@@ -157,7 +282,7 @@ void timing(void)  /* Timing function. */
     {
         /* The event list is empty, so stop the simulation. */
 
-        fprintf(outfile, "\nEvent list empty at time %f", sim_time);
+        aout_printf("\nEvent list empty at time %f", sim_time);
         exit(1);
     }
 
@@ -169,11 +294,20 @@ void timing(void)  /* Timing function. */
 
 void arrive(void)  /* Arrival event function. */
 {
-    float delay;
+    float delay, service;
+
+    /* Keep the derivative of the arrival time of this customer, the one
+       scheduled last. */
+
+    if (gradients) {
+        memcpy(d_customer, d_next_arrival, sizeof(d_customer));
+        memcpy(d_last_arrival, d_next_arrival, sizeof(d_last_arrival));
+        time_last_arrival = sim_time;
+    }
 
     /* Schedule next arrival. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    schedule_arrival();
 
     /* Check to see whether server is busy. */
 
@@ -189,8 +323,8 @@ void arrive(void)  /* Arrival event function. */
         {
             /* The queue has overflowed, so stop the simulation. */
 
-            fprintf(outfile, "\nOverflow of the array time_arrival at");
-            fprintf(outfile, " time %f", sim_time);
+            aout_printf("\nOverflow of the array time_arrival at");
+            aout_printf(" time %f", sim_time);
             exit(2);
         }
 
@@ -198,6 +332,10 @@ void arrive(void)  /* Arrival event function. */
            arriving customer at the (new) end of time_arrival. */
 
         time_arrival[num_in_[0]] = sim_time;
+        if (gradients) {
+            time_queue_ipa[0][num_in_[0]] = sim_time;
+            memcpy(d_queue[0][num_in_[0]], d_customer, sizeof(d_customer));
+        }
     }
 
     else
@@ -216,7 +354,10 @@ void arrive(void)  /* Arrival event function. */
 
         /* Schedule a transfer (arrival completion). */
 
-        time_next_event[2] = sim_time + expon(mean_service[0]);
+        service            = expon(mean_service[0]);
+        time_next_event[2] = sim_time + service;
+        if (gradients)
+            ipa_start(0, d_customer, d_customer, sim_time, service);
     }
 }
 
@@ -225,8 +366,15 @@ void transfer(void) /* Transfer event function. */
 {
     /* STEP 1: Departure from server 1. */
 
-    int   i;
-    float delay;
+    int    i;
+    float  delay, service;
+    double d_leaving[PARAMS];
+
+    /* Keep the derivative of the departure time of the customer leaving,
+       which is also that of its arrival at server 2. */
+
+    if (gradients)
+        memcpy(d_leaving, d_depart[0], sizeof(d_leaving));
 
     /* Check to see whether the queue is empty. */
 
@@ -255,7 +403,19 @@ void transfer(void) /* Transfer event function. */
         /* Increment the number of customers delayed, and schedule transfer. */
 
         ++num_custs_delayed[0];
-        time_next_event[2] = sim_time + expon(mean_service[0]);
+        service            = expon(mean_service[0]);
+        time_next_event[2] = sim_time + service;
+
+        /* The customer starts service when the one leaving departs. */
+
+        if (gradients) {
+            ipa_start(0, d_leaving, d_queue[0][1], time_queue_ipa[0][1],
+                      service);
+            memmove(d_queue[0][1], d_queue[0][2],
+                    num_in_[0] * sizeof(d_queue[0][0]));
+            memmove(&time_queue_ipa[0][1], &time_queue_ipa[0][2],
+                    num_in_[0] * sizeof(float));
+        }
 
         /* Move each customer in queue (if any) up one place. */
 
@@ -287,8 +447,8 @@ void transfer(void) /* Transfer event function. */
         {
             /* The queue has overflowed, so stop the simulation. */
 
-            fprintf(outfile, "\nOverflow of the array time_transfer at");
-            fprintf(outfile, " time %f", sim_time);
+            aout_printf("\nOverflow of the array time_transfer at");
+            aout_printf(" time %f", sim_time);
             exit(2);
         }
 
@@ -296,6 +456,10 @@ void transfer(void) /* Transfer event function. */
            arriving customer at the (new) end of time_arrival. */
 
         time_transfer[num_in_[1]] = sim_time;
+        if (gradients) {
+            time_queue_ipa[1][num_in_[1]] = sim_time;
+            memcpy(d_queue[1][num_in_[1]], d_leaving, sizeof(d_leaving));
+        }
     }
 
     else
@@ -314,15 +478,24 @@ void transfer(void) /* Transfer event function. */
 
         /* Schedule a departure (transfer completion). */
 
-        time_next_event[3] = sim_time + expon(mean_service[1]);
+        service            = expon(mean_service[1]);
+        time_next_event[3] = sim_time + service;
+        if (gradients)
+            ipa_start(1, d_leaving, d_leaving, sim_time, service);
     }
 }
 
 
 void depart(void)  /* Departure event function. */
 {
-    int   i;
-    float delay;
+    int    i;
+    float  delay, service;
+    double d_leaving[PARAMS];
+
+    /* Keep the derivative of the departure time of the customer leaving. */
+
+    if (gradients)
+        memcpy(d_leaving, d_depart[1], sizeof(d_leaving));
 
     /* Check to see whether the queue is empty. */
 
@@ -351,7 +524,19 @@ void depart(void)  /* Departure event function. */
         /* Increment the number of customers delayed, and schedule departure. */
 
         ++num_custs_delayed[1];
-        time_next_event[3] = sim_time + expon(mean_service[1]);
+        service            = expon(mean_service[1]);
+        time_next_event[3] = sim_time + service;
+
+        /* The customer starts service when the one leaving departs. */
+
+        if (gradients) {
+            ipa_start(1, d_leaving, d_queue[1][1], time_queue_ipa[1][1],
+                      service);
+            memmove(d_queue[1][1], d_queue[1][2],
+                    num_in_[1] * sizeof(d_queue[1][0]));
+            memmove(&time_queue_ipa[1][1], &time_queue_ipa[1][2],
+                    num_in_[1] * sizeof(float));
+        }
 
         /* Move each customer in queue (if any) up one place. */
 
@@ -367,21 +552,43 @@ void depart(void)  /* Departure event function. */
 
 void report(void)  /* Report generator function. */
 {
+    run_report r;
+    int        s;
+
+    /* Hand a copy of the totals to the writer. */
+
+    for (s = 0; s < 2; ++s) {
+        r.num_custs_delayed[s]  = num_custs_delayed[s];
+        r.total_of_delays[s]    = total_of_delays[s];
+        r.area_num_in_[s]       = area_num_in_[s];
+        r.area_server_status[s] = area_server_status[s];
+    }
+    r.sim_time = sim_time;
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     measures of a run, on
+                                                     the writer thread. */
+{
+    const run_report *r = record;
+
     /* Compute and write estimates of desired measures of performance. */
 
-    fprintf(outfile, "\n\nAverage delay in queue (1)%12.3f minutes\n\n",
-            total_of_delays[0] / num_custs_delayed[0]);
-    fprintf(outfile, "Average delay in queue (2)%12.3f minutes\n\n",
-            total_of_delays[1] / num_custs_delayed[1]);
-    fprintf(outfile, "Average number in queue (1)%11.3f\n\n",
-            area_num_in_[0] / sim_time);
-    fprintf(outfile, "Average number in queue (2)%11.3f\n\n",
-            area_num_in_[1] / sim_time);
-    fprintf(outfile, "Server 1 utilization%18.3f\n\n",
-            area_server_status[0] / sim_time);
-    fprintf(outfile, "Server 2 utilization%18.3f\n\n",
-            area_server_status[1] / sim_time);
-    fprintf(outfile, "Time simulation ended%17.3f minutes", sim_time);
+    fprintf(out, "\n\nAverage delay in queue (1)%12.3f minutes\n\n",
+            r->total_of_delays[0] / r->num_custs_delayed[0]);
+    fprintf(out, "Average delay in queue (2)%12.3f minutes\n\n",
+            r->total_of_delays[1] / r->num_custs_delayed[1]);
+    fprintf(out, "Average number in queue (1)%11.3f\n\n",
+            r->area_num_in_[0] / r->sim_time);
+    fprintf(out, "Average number in queue (2)%11.3f\n\n",
+            r->area_num_in_[1] / r->sim_time);
+    fprintf(out, "Server 1 utilization%18.3f\n\n",
+            r->area_server_status[0] / r->sim_time);
+    fprintf(out, "Server 2 utilization%18.3f\n\n",
+            r->area_server_status[1] / r->sim_time);
+    fprintf(out, "Time simulation ended%17.3f minutes", r->sim_time);
 }
 
 
@@ -405,6 +612,263 @@ void update_time_avg_stats(int s)  /* Update area accumulators for
 }
 
 
+void schedule_arrival(void)  /* Schedule the next arrival. */
+{
+    float interarrival = expon(mean_interarrival);
+
+    time_next_event[1] = sim_time + interarrival;
+
+    /* An exponential variate is its mean times a fixed -ln(U), so its
+       derivative with respect to the mean is the variate over the mean. */
+
+    if (gradients)
+        d_next_arrival[0] += interarrival / mean_interarrival;
+}
+
+
+void ipa_start(int queue_id, const double d_start[], const double d_arrive[],
+               float time_arrive, float service)
+    /* Propagate the derivatives through a start of service at queue
+       "queue_id" of the customer that arrived at time "time_arrive". */
+{
+    int p, q = queue_id + 1;  /* Index of the mean service time in PARAMS. */
+
+    /* The start of service is the arrival if the server was idle and the
+       previous departure otherwise, and d_start is the derivative of
+       whichever it was.  The delay is the start less the arrival, and the
+       departure the start plus the service time, whose derivative is the
+       service time over its mean. */
+
+    for (p = 0; p < PARAMS; ++p) {
+        d_total_of_delays[queue_id][p] += d_start[p] - d_arrive[p];
+        d_depart[queue_id][p]           = d_start[p];
+    }
+    d_depart[queue_id][q]           += service / mean_service[queue_id];
+    d_total_of_service[queue_id][q] += service / mean_service[queue_id];
+    ++num_starts_ipa[queue_id];
+    total_of_delays_ipa[queue_id]  += sim_time - time_arrive;
+    total_of_service_ipa[queue_id] += service;
+}
+
+
+void report_gradients(void)  /* Write the gradients of the run just reported,
+                                and add them to the sums over the runs. */
+{
+    static const char *label[GRADIENTS] = {
+        "Average delay in queue (1)", "Average delay in queue (2)",
+        "Average number in queue (1)", "Average number in queue (2)",
+        "Server 1 utilization", "Server 2 utilization" };
+    double g, m;
+    int    i, p, q;
+
+    /* The delay gradients are averages over the customers delayed.  A time
+       average m = X / T, where the area X is the total of the delays or of
+       the service times, moves with both X and the length T of the run.  T
+       is taken as the time of the last arrival, whose derivative is known,
+       so that the derivative of m is dX / T - m dT / T. */
+
+    aout_printf("\n\nGradient with respect to mean %13s%13s%13s\n",
+                "interarrival", "service (1)", "service (2)");
+    for (i = 0; i < GRADIENTS; ++i) {
+        aout_printf("%-30s", label[i]);
+        q = i % 2;
+        for (p = 0; p < PARAMS; ++p) {
+            if (i < 2)
+                g = d_total_of_delays[q][p] / num_starts_ipa[q];
+            else {
+                if (i < 4) {
+                    m = total_of_delays_ipa[q] / time_last_arrival;
+                    g = d_total_of_delays[q][p] / time_last_arrival;
+                }
+                else {
+                    m = total_of_service_ipa[q] / time_last_arrival;
+                    g = d_total_of_service[q][p] / time_last_arrival;
+                }
+                g -= m * d_last_arrival[p] / time_last_arrival;
+            }
+            aout_printf("%13.3f", g);
+            sum_gradient[i][p]    += g;
+            sum_sq_gradient[i][p] += g * g;
+        }
+        aout_printf("\n");
+    }
+}
+
+
+void report_gradient_summary(void)  /* Write the mean gradients over the
+                                       runs, with the exact steady-state
+                                       gradients when there are any. */
+{
+    static const char *label[GRADIENTS] = {
+        "Average delay in queue (1)", "Average delay in queue (2)",
+        "Average number in queue (1)", "Average number in queue (2)",
+        "Server 1 utilization", "Server 2 utilization" };
+    static const char *param[PARAMS] = {
+        "mean interarrival time", "mean service time (1)",
+        "mean service time (2)" };
+    jackson_station up[2], down[2];
+    float           inputs[PARAMS], h;
+    double          exact[GRADIENTS][PARAMS], mean, var, half_width;
+    int             i, p, q, stable = 1;
+
+    /* Differentiate the product-form measures numerically, by central
+       differences in each input. */
+
+    for (p = 0; p < PARAMS && stable; ++p) {
+        inputs[0] = mean_interarrival;
+        inputs[1] = mean_service[0];
+        inputs[2] = mean_service[1];
+        h = 1.0e-3 * inputs[p];
+        inputs[p] += h;
+        stable = jackson_tandem(inputs[0], &inputs[1], 2, up);
+        inputs[p] -= 2 * h;
+        stable = stable && jackson_tandem(inputs[0], &inputs[1], 2, down);
+        for (q = 0; q < 2; ++q) {
+            exact[q][p]     = (up[q].avg_delay_in_queue -
+                               down[q].avg_delay_in_queue) / (2 * h);
+            exact[2 + q][p] = (up[q].avg_num_in_queue -
+                               down[q].avg_num_in_queue) / (2 * h);
+            exact[4 + q][p] = (up[q].utilization -
+                               down[q].utilization) / (2 * h);
+        }
+    }
+
+    for (p = 0; p < PARAMS; ++p) {
+        aout_printf("\n\nGradients with respect to the %s (%d runs)\n\n",
+                    param[p], REPS);
+        aout_printf("%-28s%10s%10s%10s\n", "Measure",
+                    stable ? "Exact" : "", "Mean", "+/-");
+        for (i = 0; i < GRADIENTS; ++i) {
+            mean       = sum_gradient[i][p] / REPS;
+            var        = (sum_sq_gradient[i][p] - REPS * mean * mean) /
+                         (REPS - 1);
+            half_width = T_CRIT * sqrt(var > 0.0 ? var / REPS : 0.0);
+            aout_printf("%-28s", label[i]);
+            if (stable)
+                aout_printf("%10.3f", exact[i][p]);
+            else
+                aout_printf("%10s", "");
+            aout_printf("%10.3f%10.3f\n", mean, half_width);
+        }
+    }
+}
+
+
+void simulate_uniformized(void)  /* Run to the time cutoff as a uniformized
+                                    continuous-time Markov chain. */
+{
+    double rate[3], rate_total, u, time, time_since_last_event,
+           area_queue[2] = {0.0, 0.0}, area_busy[2] = {0.0, 0.0};
+    int    s, last;
+
+    /* With exponential interarrival and service times, the numbers in queue
+       and the server statuses form a Markov chain, which leaves each state
+       by an arrival at rate 1 / mean_interarrival and by a completion at
+       server s at rate 1 / mean_service[s] while that server is busy.  The
+       chain is run on one exponential clock at the total of the three rates,
+       busy or not, drawing at each tick which of the three it was; a
+       completion drawn for an idle server changes nothing.  There is no
+       event list, and the areas are taken exactly over the ticks up to the
+       time cutoff.  Ticks come from stream 1 and the draws from stream 2. */
+
+    rate[0]    = 1.0 / mean_interarrival;
+    rate[1]    = 1.0 / mean_service[0];
+    rate[2]    = 1.0 / mean_service[1];
+    rate_total = rate[0] + rate[1] + rate[2];
+
+    for (s = 0; s < 2; ++s) {
+        num_custs_delayed[s]    = 0;
+        head_ctmc[s]            = 0;
+        total_of_delays_ctmc[s] = 0.0;
+    }
+
+    for (time = 0.0, last = 0; !last; ) {
+
+        /* Advance to the next tick, or to the cutoff, and update the
+           areas over the time since the last one. */
+
+        time_since_last_event = -log(lcgrand(1)) / rate_total;
+        if (time + time_since_last_event >= num_time_max) {
+            time_since_last_event = num_time_max - time;
+            last = 1;
+        }
+        for (s = 0; s < 2; ++s) {
+            area_queue[s] += num_in_[s] * time_since_last_event;
+            area_busy[s]  += server_status[s] * time_since_last_event;
+        }
+        time += time_since_last_event;
+        if (last)
+            break;
+
+        /* Draw the transition: an arrival, a transfer from server 1 to
+           server 2 or a departure from server 2. */
+
+        u = lcgrand(2) * rate_total;
+        if (u < rate[0])
+            enter_ctmc(0, time);
+        else if (u < rate[0] + rate[1]) {
+            if (server_status[0] == BUSY) {
+                leave_ctmc(0, time);
+                enter_ctmc(1, time);
+            }
+        }
+        else if (server_status[1] == BUSY)
+            leave_ctmc(1, time);
+    }
+
+    /* Hand the statistics to the report generator. */
+
+    sim_time = num_time_max;
+    for (s = 0; s < 2; ++s) {
+        total_of_delays[s]    = total_of_delays_ctmc[s];
+        area_num_in_[s]       = area_queue[s];
+        area_server_status[s] = area_busy[s];
+    }
+}
+
+
+void enter_ctmc(int s, double time)  /* A customer joins server s of the
+                                        uniformized chain. */
+{
+    if (server_status[s] == BUSY) {
+
+        /* Server is busy, so the customer joins the end of the queue. */
+
+        if (++num_in_[s] > Q_LIMIT) {
+            aout_printf("\nOverflow of the queue at server %d at", s + 1);
+            aout_printf(" time %f", time);
+            exit(2);
+        }
+        time_queue_ctmc[s][(head_ctmc[s] + num_in_[s] - 1) % (Q_LIMIT + 1)] =
+            time;
+    }
+    else {
+
+        /* Server is idle, so the customer starts with no delay. */
+
+        ++num_custs_delayed[s];
+        server_status[s] = BUSY;
+    }
+}
+
+
+void leave_ctmc(int s, double time)  /* A customer completes service at
+                                        server s of the uniformized chain. */
+{
+    if (num_in_[s] == 0) {
+        server_status[s] = IDLE;
+        return;
+    }
+
+    /* The customer at the head of the queue starts service. */
+
+    total_of_delays_ctmc[s] += time - time_queue_ctmc[s][head_ctmc[s]];
+    head_ctmc[s] = (head_ctmc[s] + 1) % (Q_LIMIT + 1);
+    --num_in_[s];
+    ++num_custs_delayed[s];
+}
+
+
 float expon(float mean)  /* Exponential variate generation function. */
 {
     /* Return an exponential random variate with mean "mean". */
@@ -412,3 +876,97 @@ float expon(float mean)  /* Exponential variate generation function. */
     return -mean * log(lcgrand(1));
 }
 
+
+int report_analytic(void)  /* Write the exact steady-state measures of the
+                              product-form network, returning 0 (so the model
+                              is simulated instead) if a server has no
+                              steady state. */
+{
+    jackson_station station[2];
+    int             i;
+
+    if (!jackson_tandem(mean_interarrival, mean_service, 2, station)) {
+        for (i = 0; i < 2; i++)
+            if (!station[i].stable)
+                aout_printf("Server %d utilization %.3f has no steady"
+                            " state; simulating\n\n", i + 1,
+                            station[i].utilization);
+        return 0;
+    }
+
+    aout_printf("Steady-state (product-form) measures\n\n");
+    aout_printf("\nAverage delay in queue (1)%12.3f minutes\n\n",
+                station[0].avg_delay_in_queue);
+    aout_printf("Average delay in queue (2)%12.3f minutes\n\n",
+                station[1].avg_delay_in_queue);
+    aout_printf("Average number in queue (1)%11.3f\n\n",
+                station[0].avg_num_in_queue);
+    aout_printf("Average number in queue (2)%11.3f\n\n",
+                station[1].avg_num_in_queue);
+    aout_printf("Server 1 utilization%18.3f\n\n",
+                station[0].utilization);
+    aout_printf("Server 2 utilization%18.3f\n",
+                station[1].utilization);
+    return 1;
+}
+
+
+void record_measures(void)  /* Add the measures of the run just reported to
+                               the cross-check sums. */
+{
+    float measure[MEASURES];
+    int   i;
+
+    measure[0] = total_of_delays[0] / num_custs_delayed[0];
+    measure[1] = total_of_delays[1] / num_custs_delayed[1];
+    measure[2] = area_num_in_[0] / sim_time;
+    measure[3] = area_num_in_[1] / sim_time;
+    measure[4] = area_server_status[0] / sim_time;
+    measure[5] = area_server_status[1] / sim_time;
+
+    for (i = 0; i < MEASURES; i++) {
+        sum_measure[i]    += measure[i];
+        sum_sq_measure[i] += measure[i] * measure[i];
+    }
+}
+
+
+void report_cross_check(void)  /* Compare the mean over the runs with the
+                                  exact steady-state value of each measure. */
+{
+    static const char *label[MEASURES] = {
+        "Average delay in queue (1)", "Average delay in queue (2)",
+        "Average number in queue (1)", "Average number in queue (2)",
+        "Server 1 utilization", "Server 2 utilization" };
+    jackson_station station[2];
+    double          exact[MEASURES], mean, var, half_width;
+    int             i;
+
+    if (!jackson_tandem(mean_interarrival, mean_service, 2, station)) {
+        aout_printf("\n\nNo steady state to cross-check against\n");
+        return;
+    }
+    exact[0] = station[0].avg_delay_in_queue;
+    exact[1] = station[1].avg_delay_in_queue;
+    exact[2] = station[0].avg_num_in_queue;
+    exact[3] = station[1].avg_num_in_queue;
+    exact[4] = station[0].utilization;
+    exact[5] = station[1].utilization;
+
+    /* Flag each measure whose exact value lies outside the 95% confidence
+       interval of the simulated mean. */
+
+    aout_printf("\n\nCross-check against steady state (%d runs)\n\n",
+                REPS);
+    aout_printf("%-28s%10s%10s%10s\n", "Measure", "Exact", "Mean",
+                "+/-");
+    for (i = 0; i < MEASURES; i++) {
+        mean       = sum_measure[i] / REPS;
+        var        = (sum_sq_measure[i] - REPS * mean * mean) / (REPS - 1);
+        half_width = T_CRIT * sqrt(var > 0.0 ? var / REPS : 0.0);
+        aout_printf("%-28s%10.3f%10.3f%10.3f%s\n", label[i], exact[i],
+                    mean, half_width,
+                    fabs(mean - exact[i]) > half_width ? "  *" : "");
+    }
+    aout_printf("\n* exact value outside the 95%% confidence interval\n");
+}
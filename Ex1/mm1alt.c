@@ -3,17 +3,24 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
+#include "evsel.h"    /* Header file for next-event selector. */
+#include "trace.h"    /* Header file for trace files. */
 
 #define Q_LIMIT 100  /* Limit on queue length. */
 #define BUSY      1  /* Mnemonics for server's being busy */
 #define IDLE      0  /* and idle. */
 
-int   next_event_type, num_custs_delayed, num_events, num_in_q, server_status;
+int   next_event_type, num_custs_delayed, num_events, num_in_q, server_status,
+      tracing, has_trace_service, uniformized;
 float area_num_in_q, area_server_status, mean_interarrival, mean_service,
       sim_time, time_arrival[Q_LIMIT + 1], time_end, time_last_event,
-      time_next_event[4], total_of_delays;
+      total_of_delays;
+_Alignas(EVSEL_ALIGN) float time_next_event[EVSEL_SIZE(3)];
 FILE  *infile, *outfile;
+trace_file   trace;
+trace_column trace_arrival, trace_service;
 
 void  initialize(void);
 void  timing(void);
@@ -21,11 +28,33 @@ void  arrive(void);
 void  depart(void);
 void  report(void);
 void  update_time_avg_stats(void);
+void  open_trace(const char *path);
+float next_arrival(void);
+float service_time(void);
+void  simulate_uniformized(void);
 float expon(float mean);
 
 
-int main()  /* Main function. */
+int main(int argc, char *argv[])  /* Main function. */
 {
+    int i;
+
+    /* Check for the options -t file (replay arrivals and service times from
+       a trace file) and -u (simulate the system as a uniformized Markov
+       chain). */
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+            open_trace(argv[++i]);
+        else if (strcmp(argv[i], "-u") == 0)
+            uniformized = 1;
+    }
+    if (uniformized && tracing) {
+        fprintf(stderr, "A uniformized chain needs exponential, not traced,"
+                " times\n");
+        exit(1);
+    }
+
     /* Open input and output files. */
 
     infile  = fopen("mm1alt.in",  "r");
@@ -47,11 +76,21 @@ int main()  /* Main function. */
             mean_interarrival);
     fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
     fprintf(outfile, "Length of the simulation%9.3f minutes\n\n", time_end);
+    if (tracing)
+        fprintf(outfile, "Trace records%20llu\n\n", trace.header->num_records);
+    if (uniformized)
+        fprintf(outfile, "Simulated as a uniformized Markov chain\n\n");
 
     /* Initialize the simulation. */
 
     initialize();
 
+    /* The uniformized chain runs to the end on its own, leaving the event
+       loop only the end-simulation event. */
+
+    if (uniformized)
+        simulate_uniformized();
+
     /* Run the simulation until it terminates after an end-simulation event
        (type 3) occurs. */
 
@@ -87,6 +126,8 @@ int main()  /* Main function. */
 
     fclose(infile);
     fclose(outfile);
+    if (tracing)
+        trace_close(&trace);
 
     return 0;
 }
@@ -111,11 +152,15 @@ void initialize(void)  /* Initialization function. */
     area_num_in_q      = 0.0;
     area_server_status = 0.0;
 
+    /* Pad the event list for the next-event selector. */
+
+    evsel_pad(time_next_event, num_events);
+
     /* Initialize event list.  Since no customers are present, the departure
        (service completion) event is eliminated from consideration.  The end-
        simulation event (type 3) is scheduled for time time_end. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    time_next_event[1] = next_arrival();
     time_next_event[2] = 1.0e+30;
     time_next_event[3] = time_end;
 }
@@ -123,18 +168,12 @@ void initialize(void)  /* Initialization function. */
 
 void timing(void)  /* Timing function. */
 {
-    int   i;
-    float min_time_next_event = 1.0e+29;
-
-    next_event_type = 0;
+    float min_time_next_event;
 
     /* Determine the event type of the next event to occur. */
 
-    for (i = 1; i <= num_events; ++i)
-            if (time_next_event[i] < min_time_next_event) {
-            min_time_next_event = time_next_event[i];
-            next_event_type     = i;
-        }
+    next_event_type = evsel_next(time_next_event, num_events,
+                                 &min_time_next_event);
 
     /* Check to see whether the event list is empty. */
 
@@ -159,7 +198,7 @@ void arrive(void)  /* Arrival event function. */
 
     /* Schedule next arrival. */
 
-    time_next_event[1] = sim_time + expon(mean_interarrival);
+    time_next_event[1] = next_arrival();
 
     /* Check to see whether server is busy. */
 
@@ -202,7 +241,7 @@ void arrive(void)  /* Arrival event function. */
 
         /* Schedule a departure (service completion). */
 
-        time_next_event[2] = sim_time + expon(mean_service);
+        time_next_event[2] = sim_time + service_time();
     }
 }
 
@@ -239,7 +278,7 @@ void depart(void)  /* Departure event function. */
         /* Increment the number of customers delayed, and schedule departure. */
 
         ++num_custs_delayed;
-        time_next_event[2] = sim_time + expon(mean_service);
+        time_next_event[2] = sim_time + service_time();
 
         /* Move each customer in queue (if any) up one place. */
 
@@ -284,6 +323,139 @@ void update_time_avg_stats(void)  /* Update area accumulators for time-average
 }
 
 
+void open_trace(const char *path)  /* Map a trace file and find its
+                                      columns. */
+{
+    if (trace_open(&trace, path) < 0) {
+        fprintf(stderr, "Cannot read trace file %s\n", path);
+        exit(1);
+    }
+    if (trace_column_open(&trace, "arrival", &trace_arrival) < 0) {
+        fprintf(stderr, "Trace file %s has no arrival column\n", path);
+        exit(1);
+    }
+    has_trace_service =
+        trace_column_open(&trace, "service1", &trace_service) == 0;
+    tracing = 1;
+}
+
+
+float next_arrival(void)  /* Time of the next arrival, from the trace if
+                             there is one. */
+{
+    double time;
+
+    if (!tracing)
+        return sim_time + expon(mean_interarrival);
+
+    /* Trace arrival times are absolute, and no more arrive once the trace
+       runs out. */
+
+    if (trace_next(&trace_arrival, &time))
+        return (float) time;
+    return 1.0e+30;
+}
+
+
+float service_time(void)  /* Service time of the customer starting
+                             service. */
+{
+    double time;
+
+    /* Take the next service time from the trace if it has a service1
+       column, and generate one when the column is missing or used up. */
+
+    if (has_trace_service && trace_next(&trace_service, &time))
+        return (float) time;
+    return expon(mean_service);
+}
+
+
+void simulate_uniformized(void)  /* Run to the end of the simulation as a
+                                    uniformized continuous-time Markov
+                                    chain. */
+{
+    double rate_arrival, rate_service, rate_total, time, time_since_last_event,
+           time_queue[Q_LIMIT + 1], area_queue = 0.0, area_busy = 0.0,
+           total_delays = 0.0;
+    int    head = 0, last;
+
+    /* With exponential interarrival and service times, the number in queue
+       and the server status form a Markov chain, which leaves each state by
+       an arrival at rate 1 / mean_interarrival and by a completion at rate
+       1 / mean_service while the server is busy.  The chain is run on one
+       exponential clock at the sum of the two rates, busy or not, drawing
+       at each tick which it was; a completion drawn for an idle server
+       changes nothing.  There is no event list, and the areas are taken
+       exactly over the ticks up to time_end.  Ticks come from stream 1 and
+       the draws from stream 2. */
+
+    rate_arrival = 1.0 / mean_interarrival;
+    rate_service = 1.0 / mean_service;
+    rate_total   = rate_arrival + rate_service;
+
+    for (time = 0.0, last = 0; !last; ) {
+
+        /* Advance to the next tick, or to the end, and update the areas
+           over the time since the last one. */
+
+        time_since_last_event = -log(lcgrand(1)) / rate_total;
+        if (time + time_since_last_event >= time_end) {
+            time_since_last_event = time_end - time;
+            last = 1;
+        }
+        area_queue += num_in_q * time_since_last_event;
+        area_busy  += server_status * time_since_last_event;
+        time       += time_since_last_event;
+        if (last)
+            break;
+
+        if (lcgrand(2) * rate_total < rate_arrival) {
+
+            /* An arrival joins the queue, or starts at once if the server
+               is idle. */
+
+            if (server_status == IDLE) {
+                ++num_custs_delayed;
+                server_status = BUSY;
+            }
+            else if (++num_in_q > Q_LIMIT) {
+                fprintf(outfile, "\nOverflow of the queue at");
+                fprintf(outfile, " time %f", time);
+                exit(2);
+            }
+            else
+                time_queue[(head + num_in_q - 1) % (Q_LIMIT + 1)] = time;
+        }
+        else if (server_status == BUSY) {
+
+            /* A completion, after which the head of the queue, if any,
+               starts service. */
+
+            if (num_in_q == 0)
+                server_status = IDLE;
+            else {
+                total_delays += time - time_queue[head];
+                head = (head + 1) % (Q_LIMIT + 1);
+                --num_in_q;
+                ++num_custs_delayed;
+            }
+        }
+    }
+
+    /* Hand the statistics over at time_end, and leave only the end-
+       simulation event scheduled. */
+
+    sim_time           = time_end;
+    time_last_event    = time_end;
+    total_of_delays    = total_delays;
+    area_num_in_q      = area_queue;
+    area_server_status = area_busy;
+    time_next_event[1] = 1.0e+30;
+    time_next_event[2] = 1.0e+30;
+}
+
+
 float expon(float mean)  /* Exponential variate generation function. */
 {
     /* Return an exponential random variate with mean "mean". */
@@ -0,0 +1,198 @@
+/* External definitions for single-server queueing system, fixed run length,
+   computed by the Lindley recursion.
+
+   The model is the one of mm1alt.c, and reads mm1alt.in, but it has no event
+   list.  In a FIFO single-server queue the delay in queue of customer n + 1
+   follows from that of customer n by the Lindley recursion
+
+       W(n+1) = max(0, W(n) + S(n) - A(n+1)),
+
+   where S(n) is the service time of customer n and A(n+1) the time between
+   the arrivals of customers n and n + 1.  Each customer is in queue from its
+   arrival until it starts service, and in service until it departs, so the
+   areas under the number-in-queue and server-busy functions are sums of
+   these intervals, clipped at the end of the run.  A customer counts as
+   delayed if it starts service by the end of the run, as in mm1alt.c.
+
+   Interarrival times come from stream 1 and service times from stream 2, so
+   each can be generated ahead in blocks: lcgrandfl fills a block of random
+   numbers, and a separate loop turns it into exponential variates.  The
+   customers therefore see different random numbers than in mm1alt.c, which
+   draws both from stream 1 in event order, and the two programs agree in
+   distribution rather than number for number.  Sums are kept in double
+   precision, since a long run exceeds the resolution of a float clock.
+
+   A long run needs far more numbers than the legacy generator has between
+   the starts of two streams, 100,000, past which the service times would
+   repeat the interarrival times.  The numbers are therefore drawn from
+   Philox, whose streams do not meet, unless the option -r name selects
+   another generator, and a run on the legacy generator stops with an error
+   at its 100,000th customer. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define BLOCK        1024  /* Number of variates generated at a time. */
+#define LEGACY_LIMIT 100000  /* Numbers in a legacy stream before the next
+                                stream starts. */
+
+int    num_custs_delayed, legacy;
+float  mean_interarrival, mean_service, time_end, interarrival[BLOCK],
+       service[BLOCK];
+double area_num_in_q, area_server_status, total_of_delays;
+FILE   *infile, *outfile;
+
+void simulate(void);
+void fill_expon(float x[], int stream, float mean);
+void report(void);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    int i, backend = LCGRAND_PHILOX;
+
+    /* Check for the option -r name (draw the random numbers from the named
+       generator). */
+
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "-r") == 0) {
+            if (i + 1 == argc) {
+                fprintf(stderr, "Usage: mm1lind [-r name]\n");
+                exit(1);
+            }
+            backend = lcgrandid(argv[++i]);
+            if (backend < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+    lcgrandbk(backend);
+    legacy = backend == LCGRAND_LEGACY;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm1alt.in",  "r");
+    outfile = fopen("mm1lind.out", "w");
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %f", &mean_interarrival, &mean_service, &time_end);
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Single-server queueing system with fixed run");
+    fprintf(outfile, " length (Lindley recursion)\n\n");
+    fprintf(outfile, "Mean interarrival time%11.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time%16.3f minutes\n\n", mean_service);
+    fprintf(outfile, "Length of the simulation%9.3f minutes\n\n", time_end);
+
+    /* Run the simulation and invoke the report generator. */
+
+    simulate();
+    report();
+
+    fclose(infile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void simulate(void)  /* Lindley recursion over the customers. */
+{
+    int    i;
+    long   num_custs = 0;
+    double delay, service_prev, time_arrival, time_start, time_departure;
+
+    /* Initialize the statistical counters.  The first customer arrives to
+       an empty system, so the recursion starts from W(0) = S(0) = 0. */
+
+    num_custs_delayed  = 0;
+    total_of_delays    = 0.0;
+    area_num_in_q      = 0.0;
+    area_server_status = 0.0;
+    time_arrival       = 0.0;
+    delay              = 0.0;
+    service_prev       = 0.0;
+
+    for (;;) {
+
+        /* Generate the next block of interarrival and service times. */
+
+        fill_expon(interarrival, 1, mean_interarrival);
+        fill_expon(service, 2, mean_service);
+
+        for (i = 0; i < BLOCK; ++i) {
+
+            /* Stop at the first customer to arrive after the end of the
+               run. */
+
+            time_arrival += interarrival[i];
+            if (time_arrival > time_end)
+                return;
+
+            /* A legacy stream runs into the next one after LEGACY_LIMIT
+               numbers. */
+
+            if (legacy && ++num_custs > LEGACY_LIMIT) {
+                fprintf(outfile, "\nThe run needs more than %d numbers of a"
+                        " legacy stream; select another generator with -r",
+                        LEGACY_LIMIT);
+                exit(2);
+            }
+
+            /* Delay in queue, by the Lindley recursion, and the times of the
+               start of service and of departure. */
+
+            delay          = fmax(0.0, delay + service_prev - interarrival[i]);
+            time_start     = time_arrival + delay;
+            time_departure = time_start + service[i];
+            service_prev   = service[i];
+
+            /* Count the delay if service starts by the end of the run. */
+
+            if (time_start <= time_end) {
+                ++num_custs_delayed;
+                total_of_delays += delay;
+            }
+
+            /* Add the time in queue and in service up to the end of the run
+               to the areas. */
+
+            area_num_in_q      += fmin(time_start, time_end) - time_arrival;
+            area_server_status += fmax(0.0, fmin(time_departure, time_end) -
+                                            fmin(time_start, time_end));
+        }
+    }
+}
+
+
+void fill_expon(float x[], int stream, float mean)  /* Fill x with BLOCK
+                                                       exponential variates
+                                                       with mean "mean". */
+{
+    int i;
+
+    lcgrandfl(x, BLOCK, stream);
+    for (i = 0; i < BLOCK; ++i)
+        x[i] = -mean * log(x[i]);
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    /* Compute and write estimates of desired measures of performance. */
+
+    fprintf(outfile, "\n\nAverage delay in queue%11.3f minutes\n\n",
+            total_of_delays / num_custs_delayed);
+    fprintf(outfile, "Average number in queue%10.3f\n\n",
+            area_num_in_q / time_end);
+    fprintf(outfile, "Server utilization%15.3f\n\n",
+            area_server_status / time_end);
+    fprintf(outfile, "Number of delays completed%7d",
+            num_custs_delayed);
+}
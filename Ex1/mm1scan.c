@@ -0,0 +1,379 @@
+/* External definitions for one long run of the tandem queueing system of
+   mm1.c, split across threads by a max-plus prefix scan.
+
+   With FIFO service and no limit on the queues, the arrival time a(n) of
+   customer n and its departure times d1(n) and d2(n) from the two servers
+   follow from those of customer n - 1:
+
+       a(n)  = a(n-1) + A(n)
+       d1(n) = max(a(n), d1(n-1)) + S1(n)
+       d2(n) = max(d1(n), d2(n-1)) + S2(n)
+
+   where A(n) is an interarrival time and S1(n) and S2(n) are service times.
+   In the max-plus algebra, where max is addition and + is multiplication,
+   this is the product of the state (a, d1, d2) with a 3 x 3 matrix, and the
+   state after a chunk of customers is the product of the chunk's matrices
+   with the state before it.  Because the matrix product is associative, the
+   run is computed in two passes over chunks of customers, one chunk per
+   thread:
+
+   1. Each thread forms the product of its chunk's matrices.  Column j of the
+      product is the state reached by running the recursion from the unit
+      vector e(j), whose entry j is 0 and others are minus infinity, so the
+      product costs three runs of the recursion side by side.
+
+   2. The main thread combines the products in order into the true state at
+      the start of each chunk, and each thread then runs its chunk from that
+      state, accumulating the delays and service times.
+
+   Interarrival times come from substream 0 of a common seed and the
+   service times at the two servers from substreams 1 and 2, and the thread
+   for a chunk jumps these ahead to the chunk's first customer with
+   lcgrandsk, so the customers see the same numbers whatever the number of
+   threads.  Thread k generates on its own streams, numbered 3k + 1 through
+   3k + 3, each started at the seed and moved to its substream.  The only
+   differences between runs with different numbers of threads come from the
+   order of floating-point additions, since times and sums are kept in
+   double precision.
+
+   Substreams need a generator other than the legacy one; Philox is used
+   unless the option -r name selects another.  Skipping ahead takes time
+   that grows with the logarithm of the skip for MRG32k3a and not at all for
+   Philox, but in proportion to it for xoshiro256++.  The legacy generator
+   uses streams 1 through 3 instead, whose starts are only 100,000 numbers
+   apart, so it is refused for runs of more customers than that.
+
+   The number of customers and of threads are read from mm1scan.in; zero
+   threads means one per processor.  The option -s runs the recursion in one
+   pass on one thread, for comparison. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+
+#define MAX_THREADS      33  /* Limit on threads, three streams each. */
+#define BLOCK          1024  /* Number of variates generated at a time. */
+#define SCAN_SEED     12345  /* Common start of the substreams. */
+#define LEGACY_LIMIT 100000  /* Numbers in a legacy stream before the next
+                                stream starts. */
+
+/* One chunk of customers and the results of its passes. */
+
+typedef struct {
+    int       id;
+    long long first, count;         /* First customer (from 0) and number. */
+    double    product[3][3];        /* Max-plus product of the chunk. */
+    double    state[3];             /* (a, d1, d2) before the chunk. */
+    double    total_of_delays[2], total_of_service[2];
+} chunk;
+
+long long num_custs;
+int       num_threads, sequential, legacy;
+long      seed[3];
+float     mean_interarrival, mean_service[2];
+double    time_end;
+chunk     chunks[MAX_THREADS];
+FILE      *infile, *scanfile, *outfile;
+
+void  *product_pass(void *);
+void  *statistics_pass(void *);
+void  start_streams(chunk *);
+void  generate(chunk *, float a[], float s1[], float s2[], int n);
+void  run_threads(void *(*pass)(void *));
+void  report(double wall_seconds);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    int             i, k, j, backend = LCGRAND_PHILOX;
+    long long       per_chunk;
+    double          x[3];
+    struct timespec wall_start, wall_stop;
+
+    /* Check for the options -s (run on one thread in one pass) and -r name
+       (draw the random numbers from the named generator). */
+
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "-s") == 0)
+            sequential = 1;
+        else if (strcmp(argv[i], "-r") == 0) {
+            if (i + 1 == argc) {
+                fprintf(stderr, "Usage: mm1scan [-s] [-r name]\n");
+                exit(1);
+            }
+            backend = lcgrandid(argv[++i]);
+            if (backend < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+    lcgrandbk(backend);
+    legacy = backend == LCGRAND_LEGACY;
+
+    /* Open input and output files. */
+
+    infile   = fopen("mm1.in",  "r");
+    scanfile = fopen("mm1scan.in", "r");
+    outfile  = fopen("mm1scan.out", "w");
+
+    /* Read input parameters.  The time cutoff of mm1.in is not used, since
+       the run is for a number of customers. */
+
+    fscanf(infile, "%f %f %f", &mean_interarrival, &(mean_service[0]),
+           &(mean_service[1]));
+    fscanf(scanfile, "%lld %d", &num_custs, &num_threads);
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads < 1 || sequential)
+        num_threads = 1;
+    if (num_threads > MAX_THREADS)
+        num_threads = MAX_THREADS;
+    if (num_threads > num_custs)
+        num_threads = (int) num_custs;
+    if (legacy && num_custs > LEGACY_LIMIT) {
+        fprintf(stderr, "The legacy generator has only %d numbers in a"
+                " stream; select another with -r\n", LEGACY_LIMIT);
+        exit(1);
+    }
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Tandem-server queueing system (max-plus scan)\n\n");
+    fprintf(outfile, "Mean interarrival time%16.3f minutes\n\n",
+            mean_interarrival);
+    fprintf(outfile, "Mean service time (server 1)%10.3f minutes\n\n",
+            mean_service[0]);
+    fprintf(outfile, "Mean service time (server 2)%10.3f minutes\n\n",
+            mean_service[1]);
+    fprintf(outfile, "Number of customers%19lld\n\n", num_custs);
+    fprintf(outfile, "Number of threads%21d\n\n", num_threads);
+
+    /* Record the starting seeds of the three legacy streams, and divide the
+       customers into one chunk per thread. */
+
+    if (legacy)
+        for (j = 0; j < 3; ++j)
+            seed[j] = lcgrandgt(j + 1);
+    per_chunk = num_custs / num_threads;
+    for (k = 0; k < num_threads; ++k) {
+        chunks[k].id    = k;
+        chunks[k].first = k * per_chunk;
+        chunks[k].count = k < num_threads - 1 ? per_chunk
+                                              : num_custs - k * per_chunk;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+    /* The first chunk starts from an empty system at time 0. */
+
+    for (j = 0; j < 3; ++j)
+        chunks[0].state[j] = 0.0;
+
+    if (num_threads > 1) {
+
+        /* Pass 1: form the product of each chunk's matrices. */
+
+        run_threads(product_pass);
+
+        /* Combine the products in order into the state before each chunk:
+           state(k + 1) = product(k) (x) state(k) in max-plus terms. */
+
+        for (k = 0; k + 1 < num_threads; ++k)
+            for (i = 0; i < 3; ++i) {
+                x[i] = -INFINITY;
+                for (j = 0; j < 3; ++j)
+                    x[i] = fmax(x[i], chunks[k].product[i][j] +
+                                      chunks[k].state[j]);
+                chunks[k + 1].state[i] = x[i];
+            }
+    }
+
+    /* Pass 2: run each chunk from its starting state for the statistics. */
+
+    run_threads(statistics_pass);
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_stop);
+
+    /* Invoke the report generator and end the simulation. */
+
+    report((wall_stop.tv_sec - wall_start.tv_sec) +
+           (wall_stop.tv_nsec - wall_start.tv_nsec) / 1.0e+9);
+
+    fclose(infile);
+    fclose(scanfile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void *product_pass(void *arg)  /* Form the max-plus product of a chunk. */
+{
+    chunk     *c = (chunk *) arg;
+    float     a[BLOCK], s1[BLOCK], s2[BLOCK];
+    double    (*p)[3] = c->product;
+    long long done;
+    int       i, j, n;
+
+    /* Start column j at the unit vector e(j).  Row i of the product holds
+       the components of the state, so p[i][j] is component i of column j. */
+
+    for (i = 0; i < 3; ++i)
+        for (j = 0; j < 3; ++j)
+            p[i][j] = i == j ? 0.0 : -INFINITY;
+
+    start_streams(c);
+    for (done = 0; done < c->count; done += n) {
+        n = c->count - done < BLOCK ? (int) (c->count - done) : BLOCK;
+        generate(c, a, s1, s2, n);
+
+        /* Run the recursion on the three columns side by side. */
+
+        for (i = 0; i < n; ++i)
+            for (j = 0; j < 3; ++j) {
+                p[0][j] += a[i];
+                p[1][j]  = fmax(p[0][j], p[1][j]) + s1[i];
+                p[2][j]  = fmax(p[1][j], p[2][j]) + s2[i];
+            }
+    }
+    return NULL;
+}
+
+
+void *statistics_pass(void *arg)  /* Run a chunk from its starting state. */
+{
+    chunk     *c = (chunk *) arg;
+    float     a[BLOCK], s1[BLOCK], s2[BLOCK];
+    double    time_arrival, time_depart1, time_depart2, time_start;
+    long long done;
+    int       i, n;
+
+    time_arrival = c->state[0];
+    time_depart1 = c->state[1];
+    time_depart2 = c->state[2];
+    c->total_of_delays[0]  = c->total_of_delays[1]  = 0.0;
+    c->total_of_service[0] = c->total_of_service[1] = 0.0;
+
+    start_streams(c);
+    for (done = 0; done < c->count; done += n) {
+        n = c->count - done < BLOCK ? (int) (c->count - done) : BLOCK;
+        generate(c, a, s1, s2, n);
+
+        for (i = 0; i < n; ++i) {
+
+            /* Arrival, then delay and service at server 1. */
+
+            time_arrival          += a[i];
+            time_start             = fmax(time_arrival, time_depart1);
+            c->total_of_delays[0] += time_start - time_arrival;
+            time_depart1           = time_start + s1[i];
+
+            /* Delay and service at server 2. */
+
+            time_start             = fmax(time_depart1, time_depart2);
+            c->total_of_delays[1] += time_start - time_depart1;
+            time_depart2           = time_start + s2[i];
+
+            c->total_of_service[0] += s1[i];
+            c->total_of_service[1] += s2[i];
+        }
+    }
+
+    /* The run ends when the last customer leaves server 2. */
+
+    if (c->id == num_threads - 1)
+        time_end = time_depart2;
+    return NULL;
+}
+
+
+void start_streams(chunk *c)  /* Point a chunk's streams at its first
+                                 customer. */
+{
+    int j, stream;
+
+    for (j = 0; j < 3; ++j) {
+        stream = 3 * c->id + j + 1;
+        if (legacy)
+            lcgrandst(seed[j], stream);
+        else {
+            lcgrandst(SCAN_SEED, stream);
+            lcgrandss(j, stream);
+        }
+        lcgrandsk(c->first, stream);
+    }
+}
+
+
+void generate(chunk *c, float a[], float s1[], float s2[], int n)
+    /* Generate the next n interarrival and service times of a chunk. */
+{
+    int i, stream = 3 * c->id + 1;
+
+    lcgrandfl(a, n, stream);
+    lcgrandfl(s1, n, stream + 1);
+    lcgrandfl(s2, n, stream + 2);
+    for (i = 0; i < n; ++i) {
+        a[i]  = -mean_interarrival * log(a[i]);
+        s1[i] = -mean_service[0] * log(s1[i]);
+        s2[i] = -mean_service[1] * log(s2[i]);
+    }
+}
+
+
+void run_threads(void *(*pass)(void *))  /* Run a pass on every chunk. */
+{
+    pthread_t threads[MAX_THREADS];
+    int       k;
+
+    /* The main thread takes the first chunk itself. */
+
+    for (k = 1; k < num_threads; ++k)
+        if (pthread_create(&threads[k], NULL, pass, &chunks[k]) != 0) {
+            fprintf(outfile, "\nCannot start thread %d", k);
+            exit(2);
+        }
+    pass(&chunks[0]);
+    for (k = 1; k < num_threads; ++k)
+        pthread_join(threads[k], NULL);
+}
+
+
+void report(double wall_seconds)  /* Report generator function. */
+{
+    double total_of_delays[2] = {0.0, 0.0}, total_of_service[2] = {0.0, 0.0};
+    int    k, j;
+
+    /* Sum the chunks' accumulators in order. */
+
+    for (k = 0; k < num_threads; ++k)
+        for (j = 0; j < 2; ++j) {
+            total_of_delays[j]  += chunks[k].total_of_delays[j];
+            total_of_service[j] += chunks[k].total_of_service[j];
+        }
+
+    /* Compute and write estimates of desired measures of performance.  The
+       area under a number-in-queue function is the total of the delays in
+       that queue, and the area under a server-busy function is the total of
+       the service times. */
+
+    fprintf(outfile, "\nAverage delay in queue (1)%12.3f minutes\n\n",
+            total_of_delays[0] / num_custs);
+    fprintf(outfile, "Average delay in queue (2)%12.3f minutes\n\n",
+            total_of_delays[1] / num_custs);
+    fprintf(outfile, "Average number in queue (1)%11.3f\n\n",
+            total_of_delays[0] / time_end);
+    fprintf(outfile, "Average number in queue (2)%11.3f\n\n",
+            total_of_delays[1] / time_end);
+    fprintf(outfile, "Server 1 utilization%18.3f\n\n",
+            total_of_service[0] / time_end);
+    fprintf(outfile, "Server 2 utilization%18.3f\n\n",
+            total_of_service[1] / time_end);
+    fprintf(outfile, "Time simulation ended%17.3f minutes\n\n", time_end);
+    fprintf(outfile, "Wall-clock seconds%20.2f\n", wall_seconds);
+}
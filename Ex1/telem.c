@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "telem.h"
+
+// State of the writer.
+static telem_segment *segment;
+static telem_data    staged;
+static char          segment_name[256];
+static double        time_open, time_last, events_last;
+
+// Read the monotonic clock in seconds.
+static double now(void){
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1.0e+9;
+}
+
+// Copy the staged snapshot into the segment under the sequence lock.
+static void store(void){
+    unsigned long s = atomic_load_explicit(&segment->seq, memory_order_relaxed);
+
+    atomic_store_explicit(&segment->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy(&segment->data, &staged, sizeof(staged));
+    atomic_store_explicit(&segment->seq, s + 2, memory_order_release);
+}
+
+// Shared-memory names start with a slash; add one if it is missing.
+static void make_name(char *out, const char *name){
+    snprintf(out, 256, "%s%s", name[0] == '/' ? "" : "/", name);
+}
+
+// Create the segment called name and publish an empty snapshot for model.
+// Return 0, or -1 if the segment cannot be created.
+int telem_open(const char *name, const char *model){
+    int fd;
+
+    make_name(segment_name, name);
+    fd = shm_open(segment_name, O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+        return -1;
+    if (ftruncate(fd, sizeof(telem_segment)) < 0){
+        close(fd);
+        return -1;
+    }
+    segment = mmap(NULL, sizeof(telem_segment), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+    close(fd);
+    if (segment == MAP_FAILED){
+        segment = NULL;
+        return -1;
+    }
+
+    memset(&staged, 0, sizeof(staged));
+    staged.pid   = getpid();
+    staged.state = TELEM_RUNNING;
+    strncpy(staged.model, model, TELEM_NAME_LEN - 1);
+    time_open = time_last = now();
+    events_last = 0;
+    store();
+    return 0;
+}
+
+// Check whether the next snapshot is due.
+int telem_due(void){
+    return segment != NULL && now() - time_last >= TELEM_INTERVAL;
+}
+
+// Stage value number k, named name, for the next snapshot.
+void telem_value(int k, const char *name, double value){
+    if (k < 0 || k >= TELEM_VALUES)
+        return;
+    if (strncmp(staged.name[k], name, TELEM_NAME_LEN) != 0)
+        strncpy(staged.name[k], name, TELEM_NAME_LEN - 1);
+    staged.value[k] = value;
+    if (k >= staged.num_values)
+        staged.num_values = k + 1;
+}
+
+// Publish the staged values with the position of the run.
+void telem_publish(int run, double sim_time, unsigned long long events){
+    double t;
+
+    if (segment == NULL)
+        return;
+    t = now();
+    staged.run       = run;
+    staged.sim_time  = sim_time;
+    staged.wall_time = t - time_open;
+    staged.events    = events;
+    if (t > time_last && events >= events_last)
+        staged.events_per_sec = (events - events_last) / (t - time_last);
+    time_last   = t;
+    events_last = events;
+    store();
+}
+
+// Publish a final snapshot marked done, and remove the segment's name.
+// Readers that have it mapped keep the last snapshot.
+void telem_close(double sim_time, unsigned long long events){
+    if (segment == NULL)
+        return;
+    staged.state = TELEM_DONE;
+    telem_publish(staged.run, sim_time, events);
+    munmap(segment, sizeof(telem_segment));
+    shm_unlink(segment_name);
+    segment = NULL;
+}
+
+// Map the segment called name for reading.  Return NULL if there is none.
+const telem_segment* telem_attach(const char *name){
+    char          full[256];
+    telem_segment *seg;
+    int           fd;
+
+    make_name(full, name);
+    fd = shm_open(full, O_RDONLY, 0);
+    if (fd < 0)
+        return NULL;
+    seg = mmap(NULL, sizeof(telem_segment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    return seg == MAP_FAILED ? NULL : seg;
+}
+
+// Copy a consistent snapshot out of a segment, retrying while the writer is
+// part way through an update.
+void telem_read(const telem_segment *seg, telem_data *out){
+    unsigned long s1, s2;
+
+    do {
+        s1 = atomic_load_explicit(&seg->seq, memory_order_acquire);
+        memcpy(out, (const void*) &seg->data, sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+        s2 = atomic_load_explicit(&seg->seq, memory_order_relaxed);
+    } while ((s1 & 1) || s1 != s2);
+}
@@ -0,0 +1,57 @@
+#ifndef _TELEM_H
+#define _TELEM_H
+
+/*
+ * The following declarations are used for publishing live snapshots of a
+ * running simulation to a POSIX shared-memory segment, where another
+ * process can watch them.  The simulator stages its values locally and
+ * copies them into the segment under a sequence lock: the sequence number
+ * is odd while a copy is in progress, and a reader that sees it odd or
+ * changed across its own copy simply retries, so the simulator never waits
+ * on a reader.  A model should call telem_due only every TELEM_CHECK events,
+ * since it reads the clock, and publish when it returns 1.
+ */
+
+#include <stdatomic.h>
+
+#define TELEM_VALUES    16        // Limit on named values in a snapshot.
+#define TELEM_NAME_LEN  24        // Length of a value or model name.
+#define TELEM_CHECK     4096      // Events between checks of the clock.
+#define TELEM_INTERVAL  0.5       // Seconds between snapshots.
+
+#define TELEM_RUNNING   1         // Mnemonics for the state of the writer.
+#define TELEM_DONE      2
+
+// Contents of a snapshot.
+typedef struct {
+    int                pid;                   // Process of the simulator.
+    int                state;
+    char               model[TELEM_NAME_LEN];
+    int                run;                   // Replication or policy, from 1.
+    int                num_values;
+    double             sim_time;
+    double             wall_time;             // Seconds since telem_open.
+    double             events_per_sec;        // Over the last interval.
+    unsigned long long events;                // Events processed so far.
+    char               name[TELEM_VALUES][TELEM_NAME_LEN];
+    double             value[TELEM_VALUES];
+} telem_data;
+
+// Layout of the segment.
+typedef struct {
+    _Atomic unsigned long seq;
+    telem_data            data;
+} telem_segment;
+
+// Writer side.
+int  telem_open(const char *name, const char *model);
+int  telem_due(void);
+void telem_value(int k, const char *name, double value);
+void telem_publish(int run, double sim_time, unsigned long long events);
+void telem_close(double sim_time, unsigned long long events);
+
+// Reader side.
+const telem_segment* telem_attach(const char *name);
+void                 telem_read(const telem_segment*, telem_data*);
+
+#endif // _TELEM_H
@@ -0,0 +1,101 @@
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace.h"
+
+// Open a trace file and map it into memory.  Return 0, or -1 if the file
+// cannot be opened or mapped or is not a trace file.
+int trace_open(trace_file *tf, const char *path){
+    struct stat st;
+    unsigned int i;
+    unsigned long long offset;
+
+    tf->map  = NULL;
+    tf->fd   = open(path, O_RDONLY);
+    if (tf->fd < 0)
+        return -1;
+    if (fstat(tf->fd, &st) < 0 || (size_t) st.st_size < sizeof(trace_header)){
+        close(tf->fd);
+        return -1;
+    }
+
+    tf->map_size = st.st_size;
+    tf->map = mmap(NULL, tf->map_size, PROT_READ, MAP_PRIVATE, tf->fd, 0);
+    if (tf->map == MAP_FAILED){
+        tf->map = NULL;
+        close(tf->fd);
+        return -1;
+    }
+    tf->header = (const trace_header*) tf->map;
+
+    // Check the header, and that every column is aligned for doubles and
+    // lies inside the file.  The sizes are compared by division, since a
+    // malformed count could make the product wrap around.
+    if (memcmp(tf->header->magic, TRACE_MAGIC, 8) != 0 ||
+        tf->header->version != TRACE_VERSION ||
+        tf->header->num_columns > TRACE_MAX_COLUMNS){
+        trace_close(tf);
+        return -1;
+    }
+    for (i = 0; i < tf->header->num_columns; i++){
+        offset = tf->header->column[i].offset;
+        if (offset % sizeof(double) != 0 || offset > tf->map_size ||
+            tf->header->num_records >
+                (tf->map_size - offset) / sizeof(double)){
+            trace_close(tf);
+            return -1;
+        }
+    }
+
+    // The whole file is read front to back, column by column.
+    madvise((void*) tf->map, tf->map_size, MADV_SEQUENTIAL);
+    return 0;
+}
+
+// Unmap and close a trace file.
+void trace_close(trace_file *tf){
+    if (tf->map != NULL)
+        munmap((void*) tf->map, tf->map_size);
+    tf->map = NULL;
+    close(tf->fd);
+}
+
+// Set up a reader on the column called name.  Return 0, or -1 if the file
+// has no such column.
+int trace_column_open(const trace_file *tf, const char *name,
+                      trace_column *tc){
+    unsigned int i;
+
+    for (i = 0; i < tf->header->num_columns; i++)
+        if (strncmp(tf->header->column[i].name, name, TRACE_NAME_LEN) == 0){
+            tc->data  = (const double*) (tf->map + tf->header->column[i].offset);
+            tc->count = (long long) tf->header->num_records;
+            trace_rewind(tc);
+            return 0;
+        }
+    return -1;
+}
+
+// Start a column reader again from the first value.
+void trace_rewind(trace_column *tc){
+    tc->next    = 0;
+    tc->advised = 0;
+}
+
+// Ask the kernel to read the next window of a column ahead of use.  The
+// range is widened to whole pages, as madvise requires.
+void trace_advise(trace_column *tc){
+    long           page = sysconf(_SC_PAGESIZE);
+    long long      end  = tc->next + TRACE_WINDOW;
+    unsigned long  from, to;
+
+    if (end > tc->count)
+        end = tc->count;
+    from = (unsigned long) (tc->data + tc->next) & ~(unsigned long) (page - 1);
+    to   = (unsigned long) (tc->data + end);
+    if (to > from)
+        madvise((void*) from, to - from, MADV_WILLNEED);
+    tc->advised = end;
+}
@@ -0,0 +1,35 @@
+#ifndef _AOUT_H
+#define _AOUT_H
+
+/*
+ * The following declarations are used for handing a model's output to a
+ * background thread that formats and writes it, so the next replication
+ * runs while the last one's report goes to disk.  The model appends records
+ * to one of two buffers; when that buffer fills, or at aout_flush, it is
+ * handed to the writer and the model goes on filling the other.  A record
+ * is either a copy of the values a report needs together with the function
+ * that formats them, run on the writer thread, or text already formatted by
+ * aout_printf.  The buffers pass between the two threads through a pair of
+ * semaphores and are never shared, so neither side takes a lock, and the
+ * model waits only when the writer is a whole buffer behind.  Once the file
+ * is opened for the writer, everything written to it should go through
+ * aout_put or aout_printf to keep its order.  Whatever is still buffered is
+ * written at aout_close, or at exit if the model never calls it.  If the
+ * thread cannot be started, records are formatted and written at once.
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define AOUT_BUFFER  (64 * 1024)   // Bytes in each of the two buffers.
+
+typedef void (*aout_format)(FILE*, const void *record);
+
+int  aout_open(FILE*);
+void aout_put(aout_format, const void *record, size_t size);
+void aout_printf(const char *format, ...)
+    __attribute__((format(printf, 1, 2)));
+void aout_flush(void);
+void aout_close(void);
+
+#endif // _AOUT_H
@@ -0,0 +1,483 @@
+/* External definitions for a server farm: a dispatcher in front of many
+   parallel single-server stations, each with its own FIFO queue.
+
+   Customers arrive to the farm in a Poisson stream, and the dispatcher
+   sends each to one station at once by one of four policies:
+
+       join-shortest-queue   the station with the fewest customers
+       power-of-d            the shortest of d stations picked at random
+       round-robin           the stations in turn
+       least-work-left       the station whose work runs out soonest
+
+   Job sizes are drawn on arrival, which least-work-left needs, so each
+   station keeps the time its work runs out, and a customer's delay and
+   departure time are known when it is dispatched.  The stations with the
+   fewest customers and with the least work are kept in indexed min-heaps
+   (ixheap.h), so a dispatch costs O(log n) rather than a scan of every
+   station; the option -s uses the scan instead, for comparison, and the
+   results are the same since both break ties by lowest station number.
+   Departures are kept in a heap of their own, and the clock is in double
+   precision, since a farm of many servers sees arrivals far closer
+   together than a float clock resolves.
+
+   Every policy is run from the same random numbers: interarrival times
+   come from substream 0 of a common seed, job sizes from substream 1 and
+   the random choices of power-of-d from substream 2, drawn on streams 1, 2
+   and 3 and restarted for each policy.  A large farm draws far more numbers
+   than the legacy generator has between two streams, so this needs a
+   generator with substreams; Philox is used unless the option -r name
+   selects another.  The model reads farm.in for the number of servers, the
+   mean interarrival time to the farm, the mean service time, the length of
+   the run and d. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "ixheap.h"   /* Header file for indexed min-heap. */
+#include "aout.h"     /* Header file for the background report writer. */
+
+#define POLICIES       4  /* Number of dispatch policies. */
+#define JSQ            0  /* Mnemonics for the policies. */
+#define POWER_OF_D     1
+#define ROUND_ROBIN    2
+#define LEAST_WORK     3
+#define HEAP_INITIAL 1024  /* Initial capacity of the departure heap. */
+#define FARM_SEED   12345  /* Common start of the substreams. */
+
+/* Totals of one dispatch policy, for its row of the table. */
+
+typedef struct {
+    int    max_in_system;
+    long   num_custs_delayed;
+    double total_of_delays, area_num_in_queue, area_server_status,
+           wall_seconds;
+} policy_report;
+
+int    num_servers, num_choices, scan, *num_in_system, num_busy,
+       num_in_queue, max_in_system, next_station, num_departures,
+       capacity_departures, *station_departure;
+long   num_custs_delayed;
+double mean_interarrival, mean_service, time_end, sim_time, time_last_event,
+       time_next_arrival, area_num_in_queue, area_server_status,
+       total_of_delays, *time_work_end, *time_departure;
+ixheap *shortest, *least_work;
+FILE   *infile, *outfile;
+
+void   initialize(void);
+void   arrive(int policy);
+void   depart(int policy);
+int    dispatch(int policy);
+void   push_departure(double time, int station);
+void   pop_departure(void);
+void   update_time_avg_stats(void);
+void   report(double wall_seconds);
+void   write_report(FILE *out, const void *record);
+double expon(double mean, int stream);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    static const char *name[POLICIES] = {"Shortest queue", "Power of d",
+                                         "Round robin", "Least work"};
+    int             i, policy, backend = LCGRAND_PHILOX;
+    struct timespec wall_start, wall_stop;
+
+    /* Check for the options -s (find the shortest queue and least work by
+       scanning every station) and -r name (draw the random numbers from the
+       named generator). */
+
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "-s") == 0)
+            scan = 1;
+        else if (strcmp(argv[i], "-r") == 0) {
+            if (i + 1 == argc) {
+                fprintf(stderr, "Usage: farm [-s] [-r name]\n");
+                exit(1);
+            }
+            backend = lcgrandid(argv[++i]);
+            if (backend < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+    if (backend == LCGRAND_LEGACY) {
+        fprintf(stderr, "The farm needs a generator with substreams\n");
+        exit(1);
+    }
+    lcgrandbk(backend);
+
+    /* Open input and output files. */
+
+    infile  = fopen("farm.in",  "r");
+    outfile = fopen("farm.out", "w");
+
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
+    /* Read input parameters, and allocate the stations and heaps. */
+
+    fscanf(infile, "%d %lf %lf %lf %d", &num_servers, &mean_interarrival,
+           &mean_service, &time_end, &num_choices);
+    num_in_system     = (int *) malloc(num_servers * sizeof(int));
+    time_work_end     = (double *) malloc(num_servers * sizeof(double));
+    capacity_departures = HEAP_INITIAL;
+    time_departure    = (double *) malloc(HEAP_INITIAL * sizeof(double));
+    station_departure = (int *) malloc(HEAP_INITIAL * sizeof(int));
+    shortest          = ixheap_new(num_servers);
+    least_work        = ixheap_new(num_servers);
+    if (num_in_system == NULL || time_work_end == NULL ||
+        time_departure == NULL || station_departure == NULL ||
+        shortest == NULL || least_work == NULL) {
+        aout_printf("\nInsufficient memory for %d servers", num_servers);
+        exit(2);
+    }
+
+    /* Write report heading and input parameters. */
+
+    aout_printf("Server farm with dispatch policies\n\n");
+    aout_printf("Number of servers%21d\n\n", num_servers);
+    aout_printf("Mean interarrival time%16.8f minutes\n\n",
+                mean_interarrival);
+    aout_printf("Mean service time%21.3f minutes\n\n", mean_service);
+    aout_printf("Offered load per server%15.3f\n\n",
+                mean_service / (mean_interarrival * num_servers));
+    aout_printf("Choices for power of d%16d\n\n", num_choices);
+    aout_printf("Length of the simulation%14.3f minutes\n\n", time_end);
+    aout_printf("Dispatch lookup%23s\n\n",
+                scan ? "linear scan" : "indexed heap");
+    aout_printf("                    Average       Average");
+    aout_printf("                  Most at     Wall-clock\n");
+    aout_printf("  Policy           delay in     number in");
+    aout_printf("     Server       one station   seconds\n");
+    aout_printf("                     queue     queue/server");
+    aout_printf("  utilization\n");
+
+    /* Run the simulation for each policy. */
+
+    for (policy = 0; policy < POLICIES; ++policy) {
+
+        /* Restart the streams at their substreams, so every policy sees the
+           same random numbers, and initialize the simulation. */
+
+        for (i = 1; i <= 3; ++i) {
+            lcgrandst(FARM_SEED, i);
+            lcgrandss(i - 1, i);
+        }
+        initialize();
+
+        clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+        /* Run the simulation to the end, taking a departure before an
+           arrival at the same time. */
+
+        for (;;) {
+            if (num_departures > 0 && time_departure[0] <= time_next_arrival) {
+                if (time_departure[0] > time_end)
+                    break;
+                sim_time = time_departure[0];
+                depart(policy);
+            }
+            else {
+                if (time_next_arrival > time_end)
+                    break;
+                sim_time = time_next_arrival;
+                arrive(policy);
+            }
+        }
+        sim_time = time_end;
+        update_time_avg_stats();
+
+        clock_gettime(CLOCK_MONOTONIC, &wall_stop);
+
+        aout_printf("%-15s", name[policy]);
+        report((wall_stop.tv_sec - wall_start.tv_sec) +
+               (wall_stop.tv_nsec - wall_start.tv_nsec) / 1.0e+9);
+    }
+
+    ixheap_free(shortest);
+    ixheap_free(least_work);
+    free(num_in_system);
+    free(time_work_end);
+    free(time_departure);
+    free(station_departure);
+    fclose(infile);
+    aout_close();
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int i;
+
+    /* Initialize the simulation clock. */
+
+    sim_time = 0.0;
+
+    /* Initialize the state variables.  Every station is empty, with no work,
+       and in both heaps with key 0. */
+
+    for (i = 0; i < num_servers; ++i) {
+        num_in_system[i] = 0;
+        time_work_end[i] = 0.0;
+        ixheap_set(shortest, i, 0.0);
+        ixheap_set(least_work, i, 0.0);
+    }
+    num_busy       = 0;
+    num_in_queue   = 0;
+    max_in_system  = 0;
+    next_station   = 0;
+    num_departures = 0;
+
+    /* Initialize the statistical counters. */
+
+    time_last_event    = 0.0;
+    num_custs_delayed  = 0;
+    total_of_delays    = 0.0;
+    area_num_in_queue  = 0.0;
+    area_server_status = 0.0;
+
+    /* Schedule the first arrival. */
+
+    time_next_arrival = sim_time + expon(mean_interarrival, 1);
+}
+
+
+void arrive(int policy)  /* Arrival event function. */
+{
+    int    station;
+    double size, time_start;
+
+    update_time_avg_stats();
+
+    /* Schedule the next arrival. */
+
+    time_next_arrival = sim_time + expon(mean_interarrival, 1);
+
+    /* Draw the job size and choose a station. */
+
+    size    = expon(mean_service, 2);
+    station = dispatch(policy);
+
+    /* The customer starts when the station's work runs out, or now if it is
+       idle.  Count its delay if it starts by the end of the run. */
+
+    time_start = time_work_end[station] > sim_time ? time_work_end[station]
+                                                   : sim_time;
+    if (time_start <= time_end) {
+        ++num_custs_delayed;
+        total_of_delays += time_start - sim_time;
+    }
+    time_work_end[station] = time_start + size;
+    push_departure(time_work_end[station], station);
+
+    /* Add the customer to the station. */
+
+    if (++num_in_system[station] == 1)
+        ++num_busy;
+    else
+        ++num_in_queue;
+    if (num_in_system[station] > max_in_system)
+        max_in_system = num_in_system[station];
+
+    /* Update the heap the policy looks at, unless scanning. */
+
+    if (scan)
+        return;
+    if (policy == JSQ)
+        ixheap_set(shortest, station, num_in_system[station]);
+    else if (policy == LEAST_WORK)
+        ixheap_set(least_work, station, time_work_end[station]);
+}
+
+
+void depart(int policy)  /* Departure event function. */
+{
+    int station = station_departure[0];
+
+    update_time_avg_stats();
+    pop_departure();
+
+    /* Remove the customer from its station. */
+
+    if (--num_in_system[station] == 0)
+        --num_busy;
+    else
+        --num_in_queue;
+    if (policy == JSQ && !scan)
+        ixheap_set(shortest, station, num_in_system[station]);
+}
+
+
+int dispatch(int policy)  /* Choose the station for an arrival. */
+{
+    int i, station, best = 0;
+
+    switch (policy) {
+
+        case JSQ:
+            if (!scan)
+                return ixheap_min(shortest);
+            for (i = 1; i < num_servers; ++i)
+                if (num_in_system[i] < num_in_system[best])
+                    best = i;
+            return best;
+
+        case POWER_OF_D:
+
+            /* Take the shortest of num_choices stations drawn with
+               replacement, the first drawn on a tie. */
+
+            best = (int) (lcgrand(3) * num_servers);
+            for (i = 1; i < num_choices; ++i) {
+                station = (int) (lcgrand(3) * num_servers);
+                if (num_in_system[station] < num_in_system[best])
+                    best = station;
+            }
+            return best;
+
+        case ROUND_ROBIN:
+            station      = next_station;
+            next_station = (next_station + 1) % num_servers;
+            return station;
+
+        default:
+
+            /* The work left at a station is the time its work runs out less
+               the time now, or 0 if that has passed; taking the earliest
+               time picks, among idle stations, the one idle longest. */
+
+            if (!scan)
+                return ixheap_min(least_work);
+            for (i = 1; i < num_servers; ++i)
+                if (time_work_end[i] < time_work_end[best])
+                    best = i;
+            return best;
+    }
+}
+
+
+void push_departure(double time, int station)  /* Add a departure to the
+                                                  departure heap. */
+{
+    int pos, parent;
+
+    /* Grow the heap arrays if they are full. */
+
+    if (num_departures == capacity_departures) {
+        capacity_departures *= 2;
+        time_departure    = (double *) realloc(time_departure,
+                                capacity_departures * sizeof(double));
+        station_departure = (int *) realloc(station_departure,
+                                capacity_departures * sizeof(int));
+        if (time_departure == NULL || station_departure == NULL) {
+            aout_printf("\nInsufficient memory for departures at");
+            aout_printf(" time %f", sim_time);
+            exit(2);
+        }
+    }
+
+    /* Sift the new departure up from the bottom. */
+
+    for (pos = num_departures++; pos > 0; pos = parent) {
+        parent = (pos - 1) / 2;
+        if (time_departure[parent] <= time)
+            break;
+        time_departure[pos]    = time_departure[parent];
+        station_departure[pos] = station_departure[parent];
+    }
+    time_departure[pos]    = time;
+    station_departure[pos] = station;
+}
+
+
+void pop_departure(void)  /* Remove the first departure from the heap. */
+{
+    int    pos = 0, child, station;
+    double time;
+
+    /* Sift the last departure down from the root. */
+
+    time    = time_departure[--num_departures];
+    station = station_departure[num_departures];
+    for (;;) {
+        child = 2 * pos + 1;
+        if (child >= num_departures)
+            break;
+        if (child + 1 < num_departures &&
+            time_departure[child + 1] < time_departure[child])
+            ++child;
+        if (time <= time_departure[child])
+            break;
+        time_departure[pos]    = time_departure[child];
+        station_departure[pos] = station_departure[child];
+        pos = child;
+    }
+    time_departure[pos]    = time;
+    station_departure[pos] = station;
+}
+
+
+void update_time_avg_stats(void)  /* Update area accumulators for
+                                     time-average statistics. */
+{
+    double time_since_last_event;
+
+    /* Compute time since last event, and update last-event-time marker. */
+
+    time_since_last_event = sim_time - time_last_event;
+    time_last_event       = sim_time;
+
+    /* Update the areas under the total number in queue and the number of
+       busy servers. */
+
+    area_num_in_queue  += num_in_queue * time_since_last_event;
+    area_server_status += num_busy * time_since_last_event;
+}
+
+
+void report(double wall_seconds)  /* Report generator function. */
+{
+    policy_report r;
+
+    /* Hand a copy of the totals to the writer. */
+
+    r.max_in_system      = max_in_system;
+    r.num_custs_delayed  = num_custs_delayed;
+    r.total_of_delays    = total_of_delays;
+    r.area_num_in_queue  = area_num_in_queue;
+    r.area_server_status = area_server_status;
+    r.wall_seconds       = wall_seconds;
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     measures of a policy, on
+                                                     the writer thread. */
+{
+    const policy_report *r = record;
+
+    /* Compute and write estimates of desired measures of performance. */
+
+    fprintf(out, "%12.4f%14.4f%13.4f%14d%13.2f\n",
+            r->total_of_delays / r->num_custs_delayed,
+            r->area_num_in_queue / (time_end * num_servers),
+            r->area_server_status / (time_end * num_servers),
+            r->max_in_system, r->wall_seconds);
+}
+
+
+double expon(double mean, int stream)  /* Exponential variate generation
+                                          function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(stream));
+}
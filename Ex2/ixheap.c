@@ -0,0 +1,132 @@
+#include <stdlib.h>
+#include "ixheap.h"
+
+// Definition of an indexed heap.
+struct ixheap {
+    int    *heap;       // Items in heap order.
+    int    *pos;        // Position of each item in heap, -1 if absent.
+    double *key;        // Key of each item.
+    int    size;
+    int    capacity;
+};
+
+// Check whether item a comes out before item b.
+static int before(ixheap *h, int a, int b){
+    return h->key[a] < h->key[b] || (h->key[a] == h->key[b] && a < b);
+}
+
+// Place an item at a heap position and record the position.
+static void place(ixheap *h, int item, int pos){
+    h->heap[pos] = item;
+    h->pos[item] = pos;
+}
+
+// Move the item at pos toward the root until its parent comes before it.
+static void sift_up(ixheap *h, int pos){
+    int item = h->heap[pos];
+    while (pos > 0){
+        int parent = (pos - 1) / 2;
+        if (!before(h, item, h->heap[parent]))
+            break;
+        place(h, h->heap[parent], pos);
+        pos = parent;
+    }
+    place(h, item, pos);
+}
+
+// Move the item at pos toward the leaves until both children come after it.
+static void sift_down(ixheap *h, int pos){
+    int item = h->heap[pos];
+    for (;;){
+        int child = 2 * pos + 1;
+        if (child >= h->size)
+            break;
+        if (child + 1 < h->size && before(h, h->heap[child + 1], h->heap[child]))
+            child++;
+        if (!before(h, h->heap[child], item))
+            break;
+        place(h, h->heap[child], pos);
+        pos = child;
+    }
+    place(h, item, pos);
+}
+
+// Restore the order around pos after the key there has changed.
+static void fix(ixheap *h, int pos){
+    if (pos > 0 && before(h, h->heap[pos], h->heap[(pos - 1) / 2]))
+        sift_up(h, pos);
+    else
+        sift_down(h, pos);
+}
+
+// Allocate an empty heap for items 0 to capacity - 1.
+ixheap* ixheap_new(int capacity){
+    ixheap *h;
+    int    i;
+    if ((h = (ixheap *) malloc(sizeof(ixheap))) == NULL)
+        return NULL;
+    h->heap = (int *) malloc(capacity * sizeof(int));
+    h->pos  = (int *) malloc(capacity * sizeof(int));
+    h->key  = (double *) malloc(capacity * sizeof(double));
+    if (h->heap == NULL || h->pos == NULL || h->key == NULL){
+        ixheap_free(h);
+        return NULL;
+    }
+    for (i = 0; i < capacity; i++)
+        h->pos[i] = -1;
+    h->size     = 0;
+    h->capacity = capacity;
+    return h;
+}
+
+// Free the passed heap.
+void ixheap_free(ixheap *h){
+    free(h->heap);
+    free(h->pos);
+    free(h->key);
+    free(h);
+}
+
+// Give an item a key, adding the item if it is not in the heap.
+void ixheap_set(ixheap *h, int item, double key){
+    h->key[item] = key;
+    if (h->pos[item] < 0){
+        place(h, item, h->size++);
+        sift_up(h, h->pos[item]);
+    }
+    else
+        fix(h, h->pos[item]);
+}
+
+// Take an item out of the heap, if it is there.
+void ixheap_remove(ixheap *h, int item){
+    int pos = h->pos[item], last;
+    if (pos < 0)
+        return;
+    h->pos[item] = -1;
+    last = h->heap[--h->size];
+    if (pos == h->size)
+        return;
+    place(h, last, pos);
+    fix(h, pos);
+}
+
+// Get the item with the least key, or -1 if the heap is empty.
+int ixheap_min(ixheap *h){
+    return h->size > 0 ? h->heap[0] : -1;
+}
+
+// Get the key of an item.
+double ixheap_key(ixheap *h, int item){
+    return h->key[item];
+}
+
+// Check whether an item is in the heap.
+int ixheap_contains(ixheap *h, int item){
+    return h->pos[item] >= 0;
+}
+
+// Get the number of items in the heap.
+int ixheap_size(ixheap *h){
+    return h->size;
+}
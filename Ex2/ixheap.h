@@ -0,0 +1,27 @@
+#ifndef _IXHEAP_H
+#define _IXHEAP_H
+
+/*
+ * The following declarations are used for an indexed binary min-heap over
+ * a fixed set of items numbered 0 to capacity - 1, each with a double key.
+ * The heap keeps the position of every item, so the key of any item can be
+ * changed, or the item removed, in O(log n), and the item with the least
+ * key is found in O(1).  Items with equal keys come out lowest number
+ * first, so a linear scan that takes the first least key picks the same
+ * item.
+ */
+
+typedef struct ixheap ixheap;
+
+ixheap* ixheap_new(int capacity);
+void    ixheap_free(ixheap*);
+
+void    ixheap_set(ixheap*, int item, double key);
+void    ixheap_remove(ixheap*, int item);
+
+int     ixheap_min(ixheap*);
+double  ixheap_key(ixheap*, int item);
+int     ixheap_contains(ixheap*, int item);
+int     ixheap_size(ixheap*);
+
+#endif // _IXHEAP_H
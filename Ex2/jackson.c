@@ -0,0 +1,34 @@
+#include "jackson.h"
+
+// Fill in the M/M/1 measures of each station of a tandem line, returning 1
+// if every station is stable (utilization below 1).
+int jackson_tandem(float mean_interarrival, const float mean_service[],
+                   int num_stations, jackson_station result[]){
+    int i, all_stable = 1;
+    double rho;
+    for (i = 0; i < num_stations; i++){
+        rho = (double) mean_service[i] / mean_interarrival;
+        result[i].utilization = rho;
+        result[i].stable = rho < 1.0;
+        if (!result[i].stable){
+            all_stable = 0;
+            result[i].avg_num_in_queue   = 0.0;
+            result[i].avg_delay_in_queue = 0.0;
+            result[i].avg_num_in_system  = 0.0;
+            result[i].avg_time_in_system = 0.0;
+            continue;
+        }
+        result[i].avg_num_in_queue   = rho * rho / (1.0 - rho);
+        result[i].avg_delay_in_queue = rho * mean_service[i] / (1.0 - rho);
+        result[i].avg_num_in_system  = rho / (1.0 - rho);
+        result[i].avg_time_in_system = mean_service[i] / (1.0 - rho);
+    }
+    return all_stable;
+}
+
+// Return the mean number of customers in an infinite-server delay node,
+// which by Little's law is the arrival rate times the mean delay whatever
+// the delay distribution.
+double jackson_delay_node(float mean_interarrival, float mean_delay){
+    return (double) mean_delay / mean_interarrival;
+}
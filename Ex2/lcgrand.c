@@ -6,7 +6,34 @@
    lcgrand.h must be included in the calling program (#include "lcgrand.h")
    before using these functions.
 
-   Usage: (Three functions)
+   The same functions can instead draw on one of three other generators, the
+   backends, each with 100 streams of its own:
+
+   LCGRAND_MRG32K3A  L'Ecuyer's combined multiple recursive generator, period
+                     about 2^191.  Stream 1 starts from the seed 12345 in all
+                     six components, and stream s + 1 starts 2^127 numbers
+                     after stream s.  Substream k of a stream starts k * 2^76
+                     numbers after the start of the stream.
+
+   LCGRAND_XOSHIRO   Blackman and Vigna's xoshiro256++, period 2^256 - 1.
+                     Stream s + 1 starts 2^192 numbers after stream s, and
+                     substream k of a stream k * 2^128 numbers after its
+                     start.
+
+   LCGRAND_PHILOX    Salmon et al.'s counter-based Philox4x32-10.  Number i of
+                     substream k of stream s is a function of (i, k) under the
+                     key (s, seed), so any number of any stream is available
+                     directly, and streams need no state beyond a position.
+
+   The backend is LCGRAND_LEGACY, the generator above, unless the program is
+   compiled with LCGRAND_BACKEND defined to another, and can be changed at run
+   time with lcgrandbk.  The legacy backend returns exactly the numbers it
+   always has.  Each other backend sets up its streams once, on first use,
+   under pthread_once, so threads may start drawing on their own streams
+   together.  The other backends return U(0,1) floats with 24 bits, as the
+   legacy one does, and doubles with 53 bits (32 for MRG32k3a).
+
+   Usage: (Ten functions)
 
    1. To obtain the next U(0,1) random number from stream "stream," execute
           u = lcgrand(stream);
@@ -17,18 +44,79 @@
           lcgrandst(zset, stream);
       where lcgrandst is a void function and zset must be a long set to the
       desired seed, a number between 1 and 2147483646 (inclusive).  Default
-      seeds for all 100 streams are given in the code.
+      seeds for all 100 streams are given in the code.  For the other backends
+      zset selects a new starting point of the stream, which also becomes the
+      start of its substream 0.
 
    3. To get the current (most recently used) integer in the sequence being
       generated for stream "stream" into the long variable zget, execute
           zget = lcgrandgt(stream);
-      where lcgrandgt is a long function. */
+      where lcgrandgt is a long function.  The other backends have more state
+      than a long holds, and return -1, so a program that saves and restores
+      streams this way should check for it and fall back on substreams, or
+      refuse to run.
+
+   4. To fill the float array u[0], ..., u[n-1] with the next n U(0,1) random
+      numbers from stream "stream," execute
+          lcgrandfl(u, n, stream);
+      where lcgrandfl is a void function.  The numbers and the stream's
+      state afterward are the same as from n calls of lcgrand(stream).
+
+   5. To skip stream "stream" ahead by n numbers, execute
+          lcgrandsk(n, stream);
+      where lcgrandsk is a void function and n is a long long.  The stream
+      is left as n calls of lcgrand(stream) would leave it, in a time that
+      grows with the logarithm of n (with n for xoshiro256++).
+
+   6. To obtain the next U(0,1) random number in double precision, execute
+          u = lcgrandd(stream);
+      where lcgrandd is a double function.  For the legacy backend this is
+      the number lcgrand(stream) returns.
+
+   7. To fill the double array u[0], ..., u[n-1] with the next n numbers,
+      execute
+          lcgrandfd(u, n, stream);
+      where lcgrandfd is a void function, the double analogue of lcgrandfl.
+
+   8. To move stream "stream" to the start of its substream k, execute
+          r = lcgrandss(k, stream);
+      where lcgrandss is an int function and k a long long.  r is 0, or -1
+      for the legacy backend, whose streams are too close together to have
+      substreams.
+
+   9. To select the backend for all later calls, execute
+          r = lcgrandbk(backend);
+      where lcgrandbk is an int function and backend one of the LCGRAND_
+      constants of lcgrand.h.  r is 0, or -1 for an unknown backend.  Each
+      backend keeps its streams' positions while another is selected.
+
+   10. To look up a backend by its name ("legacy", "mrg32k3a", "xoshiro" or
+       "philox"), as for an option on a command line, execute
+          backend = lcgrandid(name);
+      where lcgrandid is an int function returning -1 for an unknown name. */
+
+#include <string.h>
+#include <pthread.h>
+#include "lcgrand.h"
 
 /* Define the constants. */
 
 #define MODLUS 2147483647
 #define MULT1       24112
 #define MULT2       26143
+#define MULT   630360016LL  /* MULT1 * MULT2. */
+#define MULT8 1674201058LL  /* MULT to the 8th power (mod MODLUS). */
+#define LANES           8   /* Sequence numbers generated side by side. */
+#define STREAMS       100   /* Number of streams of every backend. */
+
+#ifndef LCGRAND_BACKEND
+#define LCGRAND_BACKEND LCGRAND_LEGACY
+#endif
+
+static int backend = LCGRAND_BACKEND;
+
+static float  backend_float(int stream);
+static double backend_double(int stream);
 
 /* Set the default seeds for all 100 streams. */
 
@@ -58,6 +146,9 @@ float lcgrand(int stream)
 {
     long zi, lowprd, hi31;
 
+    if (backend != LCGRAND_LEGACY)
+        return backend_float(stream);
+
     zi     = zrng[stream];
     lowprd = (zi & 65535) * MULT1;
     hi31   = (zi >> 16) * MULT1 + (lowprd >> 16);
@@ -74,15 +165,570 @@ float lcgrand(int stream)
 }
 
 
+static void backend_seed(long zset, int stream);
+static void backend_skip(long long n, int stream);
+
 void lcgrandst (long zset, int stream) /* Set the current zrng for stream
                                           "stream" to zset. */
 {
+    if (backend != LCGRAND_LEGACY) {
+        backend_seed(zset, stream);
+        return;
+    }
     zrng[stream] = zset;
 }
 
 
 long lcgrandgt (int stream) /* Return the current zrng for stream "stream". */
 {
-    return zrng[stream];
+    return backend == LCGRAND_LEGACY ? zrng[stream] : -1;
+}
+
+
+/* Return a * b (mod MODLUS) for a, b < MODLUS, using 2^31 = 1 (mod MODLUS). */
+
+static long long lcgmul(long long a, long long b)
+{
+    long long p = a * b;
+
+    p = (p & MODLUS) + (p >> 31);
+    return p >= MODLUS ? p - MODLUS : p;
+}
+
+
+void lcgrandfl(float u[], int n, int stream) /* Fill u with the next n
+                                                numbers from stream
+                                                "stream." */
+{
+    long long z[LANES];
+    int       i, lane;
+
+    if (n <= 0)
+        return;
+
+    if (backend != LCGRAND_LEGACY) {
+        for (i = 0; i < n; ++i)
+            u[i] = backend_float(stream);
+        return;
+    }
+
+    /* Lane j holds numbers j, j + LANES, j + 2 * LANES, ... of the block, so
+       each lane steps by MULT8 and the lanes are independent of each other. */
+
+    z[0] = lcgmul(zrng[stream], MULT);
+    for (lane = 1; lane < LANES; ++lane)
+        z[lane] = lcgmul(z[lane - 1], MULT);
+
+    /* Write all blocks but the last, advancing each lane past its number. */
+
+    for (i = 0; i + LANES < n; i += LANES)
+        for (lane = 0; lane < LANES; ++lane) {
+            u[i + lane] = (z[lane] >> 7 | 1) / 16777216.0;
+            z[lane]     = lcgmul(z[lane], MULT8);
+        }
+
+    /* Write the last block, and leave the stream at its last number. */
+
+    for (lane = 0; i + lane < n; ++lane)
+        u[i + lane] = (z[lane] >> 7 | 1) / 16777216.0;
+    zrng[stream] = z[lane - 1];
+}
+
+
+void lcgrandsk(long long n, int stream) /* Skip stream "stream" ahead by n
+                                           numbers. */
+{
+    long long mult = MULT, jump = 1;
+
+    if (backend != LCGRAND_LEGACY) {
+        backend_skip(n, stream);
+        return;
+    }
+
+    /* Raise MULT to the nth power (mod MODLUS) by repeated squaring. */
+
+    for (; n > 0; n >>= 1) {
+        if (n & 1)
+            jump = lcgmul(jump, mult);
+        mult = lcgmul(mult, mult);
+    }
+    zrng[stream] = lcgmul(zrng[stream], jump);
+}
+
+
+double lcgrandd(int stream) /* Generate the next random number in double
+                               precision. */
+{
+    return backend == LCGRAND_LEGACY ? lcgrand(stream)
+                                     : backend_double(stream);
+}
+
+
+void lcgrandfd(double u[], int n, int stream) /* Fill u with the next n
+                                                 double numbers from stream
+                                                 "stream." */
+{
+    int i;
+
+    for (i = 0; i < n; ++i)
+        u[i] = lcgrandd(stream);
+}
+
+
+/* Convert a U(0,1) double to a float with 24 bits, as the legacy generator
+   forms its numbers, so that it cannot round to 0 or 1. */
+
+static float to_float(double u)
+{
+    return ((long) (u * 16777216.0) | 1) / 16777216.0;
+}
+
+
+/* MRG32k3a.  The state of a stream is two triples, (s[0], s[1], s[2]) for the
+   first component modulo MRG_M1 and (s[3], s[4], s[5]) for the second modulo
+   MRG_M2.  One step multiplies each triple by a 3 x 3 matrix, so a jump of n
+   steps multiplies it by the nth power of the matrix.  The powers for the
+   stream and substream spacings are formed once by repeated squaring. */
+
+#define MRG_M1   4294967087LL
+#define MRG_M2   4294944443LL
+#define MRG_A12     1403580LL
+#define MRG_A13N     810728LL
+#define MRG_A21      527612LL
+#define MRG_A23N    1370589LL
+#define MRG_NORM 2.328306549295727688e-10  /* 1 / (MRG_M1 + 1). */
+
+static long long      mrg_state[STREAMS + 1][6], mrg_start[STREAMS + 1][6],
+                      mrg_step[2][3][3], mrg_sub[2][3][3];
+static pthread_once_t mrg_once = PTHREAD_ONCE_INIT;
+
+/* Return a * b (mod m) for a, b < m < 2^32.  The product can exceed 2^63, so
+   a is taken 16 bits at a time. */
+
+static long long mulmod(long long a, long long b, long long m)
+{
+    long long r = ((a >> 16) * b) % m;
+
+    return ((r << 16) + (a & 65535) * b) % m;
+}
+
+
+/* c = a * b (mod m) for 3 x 3 matrices; c may be a or b. */
+
+static void mat_mul(long long a[3][3], long long b[3][3], long long c[3][3],
+                    long long m)
+{
+    long long t[3][3];
+    int       i, j, k;
+
+    for (i = 0; i < 3; ++i)
+        for (j = 0; j < 3; ++j) {
+            t[i][j] = 0;
+            for (k = 0; k < 3; ++k)
+                t[i][j] = (t[i][j] + mulmod(a[i][k], b[k][j], m)) % m;
+        }
+    memcpy(c, t, sizeof(t));
+}
+
+
+/* p = a^n (mod m). */
+
+static void mat_pow(long long a[3][3], long long n, long long p[3][3],
+                    long long m)
+{
+    long long b[3][3];
+    int       i, j;
+
+    memcpy(b, a, sizeof(b));
+    for (i = 0; i < 3; ++i)
+        for (j = 0; j < 3; ++j)
+            p[i][j] = i == j;
+    for (; n > 0; n >>= 1) {
+        if (n & 1)
+            mat_mul(b, p, p, m);
+        mat_mul(b, b, b, m);
+    }
+}
+
+
+/* s = a * s (mod m) for a triple s. */
+
+static void mat_vec(long long a[3][3], long long s[3], long long m)
+{
+    long long t[3];
+    int       i, k;
+
+    for (i = 0; i < 3; ++i) {
+        t[i] = 0;
+        for (k = 0; k < 3; ++k)
+            t[i] = (t[i] + mulmod(a[i][k], s[k], m)) % m;
+    }
+    memcpy(s, t, sizeof(t));
+}
+
+
+static void mrg_init(void)  /* Set up the jump matrices and the streams. */
+{
+    long long step[2][3][3] = {
+        {{0, 1, 0}, {0, 0, 1}, {MRG_M1 - MRG_A13N, MRG_A12, 0}},
+        {{0, 1, 0}, {0, 0, 1}, {MRG_M2 - MRG_A23N, 0, MRG_A21}}};
+    long long m[2] = {MRG_M1, MRG_M2}, stream_jump[2][3][3];
+    int       c, i, s;
+
+    /* Square the one-step matrices up to 2^76 and 2^127 steps. */
+
+    for (c = 0; c < 2; ++c) {
+        memcpy(mrg_step[c], step[c], sizeof(step[c]));
+        memcpy(mrg_sub[c], step[c], sizeof(step[c]));
+        for (i = 0; i < 76; ++i)
+            mat_mul(mrg_sub[c], mrg_sub[c], mrg_sub[c], m[c]);
+        memcpy(stream_jump[c], mrg_sub[c], sizeof(step[c]));
+        for (; i < 127; ++i)
+            mat_mul(stream_jump[c], stream_jump[c], stream_jump[c], m[c]);
+    }
+
+    for (i = 0; i < 6; ++i)
+        mrg_start[1][i] = 12345;
+    for (s = 1; s <= STREAMS; ++s) {
+        if (s > 1) {
+            memcpy(mrg_start[s], mrg_start[s - 1], sizeof(mrg_start[s]));
+            mat_vec(stream_jump[0], &mrg_start[s][0], MRG_M1);
+            mat_vec(stream_jump[1], &mrg_start[s][3], MRG_M2);
+        }
+        memcpy(mrg_state[s], mrg_start[s], sizeof(mrg_state[s]));
+    }
+}
+
+
+static double mrg_next(int stream)  /* Next number of MRG32k3a. */
+{
+    long long *s = mrg_state[stream], p1, p2;
+
+    p1 = (MRG_A12 * s[1] - MRG_A13N * s[0]) % MRG_M1;
+    if (p1 < 0) p1 += MRG_M1;
+    s[0] = s[1]; s[1] = s[2]; s[2] = p1;
+
+    p2 = (MRG_A21 * s[5] - MRG_A23N * s[3]) % MRG_M2;
+    if (p2 < 0) p2 += MRG_M2;
+    s[3] = s[4]; s[4] = s[5]; s[5] = p2;
+
+    return (p1 > p2 ? p1 - p2 : p1 - p2 + MRG_M1) * MRG_NORM;
+}
+
+
+static void mrg_jump(long long n, long long *s)  /* Jump n steps ahead. */
+{
+    long long p[3][3];
+
+    mat_pow(mrg_step[0], n, p, MRG_M1);
+    mat_vec(p, &s[0], MRG_M1);
+    mat_pow(mrg_step[1], n, p, MRG_M2);
+    mat_vec(p, &s[3], MRG_M2);
+}
+
+
+/* xoshiro256++.  Jumps of 2^128 and 2^192 steps are made with Vigna's jump
+   polynomials.  The streams start from a state seeded by splitmix64. */
+
+static unsigned long long xo_state[STREAMS + 1][4], xo_start[STREAMS + 1][4];
+static pthread_once_t     xo_once = PTHREAD_ONCE_INIT;
+
+static const unsigned long long xo_jump_128[4] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+static const unsigned long long xo_jump_192[4] = {
+    0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+    0x77710069854ee241ULL, 0x39109bb02acbe635ULL};
+
+static unsigned long long rotl(unsigned long long x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+
+static unsigned long long xo_next(unsigned long long s[4])  /* Next 64 bits
+                                                              of
+                                                              xoshiro256++. */
+{
+    unsigned long long result = rotl(s[0] + s[3], 23) + s[0],
+                       t      = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3]  = rotl(s[3], 45);
+    return result;
+}
+
+
+static void xo_jump(unsigned long long s[4], const unsigned long long jump[4])
+{
+    unsigned long long t[4] = {0, 0, 0, 0};
+    int                i, b;
+
+    for (i = 0; i < 4; ++i)
+        for (b = 0; b < 64; ++b) {
+            if (jump[i] & 1ULL << b) {
+                t[0] ^= s[0];
+                t[1] ^= s[1];
+                t[2] ^= s[2];
+                t[3] ^= s[3];
+            }
+            xo_next(s);
+        }
+    memcpy(s, t, sizeof(t));
+}
+
+
+static void xo_seed(unsigned long long seed, unsigned long long s[4])
+{
+    unsigned long long z;
+    int                i;
+
+    /* Fill the state from splitmix64, which never gives four zeros. */
+
+    for (i = 0; i < 4; ++i) {
+        z    = (seed += 0x9e3779b97f4a7c15ULL);
+        z    = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z    = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        s[i] = z ^ (z >> 31);
+    }
+}
+
+
+static void xo_init(void)  /* Set up the streams. */
+{
+    int s;
+
+    xo_seed(12345, xo_start[1]);
+    for (s = 1; s <= STREAMS; ++s) {
+        if (s > 1) {
+            memcpy(xo_start[s], xo_start[s - 1], sizeof(xo_start[s]));
+            xo_jump(xo_start[s], xo_jump_192);
+        }
+        memcpy(xo_state[s], xo_start[s], sizeof(xo_state[s]));
+    }
+}
+
+
+/* Philox4x32-10.  Each block of four 32-bit numbers is ten rounds of a keyed
+   bijection applied to the counter (i, i >> 32, k, k >> 32) for block i of
+   substream k.  A stream keeps its key, substream and the index of its next
+   32-bit number, and the block that number comes from. */
+
+#define PH_M0 0xD2511F53U
+#define PH_M1 0xCD9E8D57U
+#define PH_W0 0x9E3779B9U
+#define PH_W1 0xBB67AE85U
+
+static unsigned int       ph_key[STREAMS + 1][2], ph_block[STREAMS + 1][4];
+static unsigned long long ph_index[STREAMS + 1], ph_substream[STREAMS + 1],
+                          ph_held[STREAMS + 1];  /* Block held, plus 1. */
+static pthread_once_t     ph_once = PTHREAD_ONCE_INIT;
+
+/* Philox4x32-10 of counter c under key k, left in c. */
+
+static void philox(unsigned int c[4], const unsigned int k[2])
+{
+    unsigned long long p0, p1;
+    unsigned int       k0 = k[0], k1 = k[1];
+    int                round;
+
+    for (round = 0; round < 10; ++round) {
+        p0   = (unsigned long long) PH_M0 * c[0];
+        p1   = (unsigned long long) PH_M1 * c[2];
+        c[0] = (unsigned int) (p1 >> 32) ^ c[1] ^ k0;
+        c[1] = (unsigned int) p1;
+        c[2] = (unsigned int) (p0 >> 32) ^ c[3] ^ k1;
+        c[3] = (unsigned int) p0;
+        k0  += PH_W0;
+        k1  += PH_W1;
+    }
+}
+
+
+static void ph_init(void)  /* Key the streams by their numbers. */
+{
+    int s;
+
+    for (s = 1; s <= STREAMS; ++s) {
+        ph_key[s][0]    = s;
+        ph_key[s][1]    = 0;
+        ph_index[s]     = 0;
+        ph_substream[s] = 0;
+        ph_held[s]      = 0;
+    }
+}
+
+
+static unsigned int ph_next(int stream)  /* Next 32 bits of Philox. */
+{
+    unsigned long long i = ph_index[stream]++, block = i >> 2;
+    unsigned int       *c = ph_block[stream];
+
+    /* Compute the block the number comes from, unless it is held already. */
+
+    if (ph_held[stream] != block + 1) {
+        c[0] = (unsigned int) block;
+        c[1] = (unsigned int) (block >> 32);
+        c[2] = (unsigned int) ph_substream[stream];
+        c[3] = (unsigned int) (ph_substream[stream] >> 32);
+        philox(c, ph_key[stream]);
+        ph_held[stream] = block + 1;
+    }
+    return c[i & 3];
+}
+
+
+/* Dispatch to the selected backend other than the legacy one. */
+
+static void backend_ready(void)  /* Set up the backend on first use, once
+                                     however many threads get here. */
+{
+    if (backend == LCGRAND_MRG32K3A)
+        pthread_once(&mrg_once, mrg_init);
+    else if (backend == LCGRAND_XOSHIRO)
+        pthread_once(&xo_once, xo_init);
+    else if (backend == LCGRAND_PHILOX)
+        pthread_once(&ph_once, ph_init);
+}
+
+
+static float backend_float(int stream)
+{
+    backend_ready();
+    switch (backend) {
+        case LCGRAND_MRG32K3A:
+            return to_float(mrg_next(stream));
+        case LCGRAND_XOSHIRO:
+            return ((xo_next(xo_state[stream]) >> 40) | 1) / 16777216.0;
+        default:
+            return ((ph_next(stream) >> 8) | 1) / 16777216.0;
+    }
+}
+
+
+static double backend_double(int stream)
+{
+    unsigned long long hi;
+
+    backend_ready();
+    switch (backend) {
+        case LCGRAND_MRG32K3A:
+            return mrg_next(stream);
+        case LCGRAND_XOSHIRO:
+            return ((xo_next(xo_state[stream]) >> 11) + 0.5) /
+                   9007199254740992.0;
+        default:
+            hi = ph_next(stream);
+            return (((hi << 21) ^ (ph_next(stream) >> 11)) + 0.5) /
+                   9007199254740992.0;
+    }
 }
 
+
+static void backend_seed(long zset, int stream)
+{
+    int i;
+
+    backend_ready();
+    switch (backend) {
+        case LCGRAND_MRG32K3A:
+            for (i = 0; i < 6; ++i)
+                mrg_start[stream][i] = zset;
+            memcpy(mrg_state[stream], mrg_start[stream],
+                   sizeof(mrg_state[stream]));
+            break;
+        case LCGRAND_XOSHIRO:
+            xo_seed((unsigned long long) zset, xo_start[stream]);
+            memcpy(xo_state[stream], xo_start[stream],
+                   sizeof(xo_state[stream]));
+            break;
+        default:
+            /* Key 0 is no stream's default key, and the start depends on
+               zset alone, as for the other backends. */
+
+            ph_key[stream][0]    = 0;
+            ph_key[stream][1]    = (unsigned int) zset;
+            ph_index[stream]     = 0;
+            ph_substream[stream] = 0;
+            ph_held[stream]      = 0;
+            break;
+    }
+}
+
+
+static void backend_skip(long long n, int stream)
+{
+    backend_ready();
+    switch (backend) {
+        case LCGRAND_MRG32K3A:
+            mrg_jump(n, mrg_state[stream]);
+            break;
+        case LCGRAND_XOSHIRO:
+            for (; n > 0; --n)
+                xo_next(xo_state[stream]);
+            break;
+        default:
+            ph_index[stream] += n;
+            break;
+    }
+}
+
+
+int lcgrandss(long long substream, int stream) /* Move stream "stream" to
+                                                  the start of a
+                                                  substream. */
+{
+    long long p[3][3];
+
+    if (backend == LCGRAND_LEGACY)
+        return -1;
+    backend_ready();
+    switch (backend) {
+        case LCGRAND_MRG32K3A:
+            memcpy(mrg_state[stream], mrg_start[stream],
+                   sizeof(mrg_state[stream]));
+            mat_pow(mrg_sub[0], substream, p, MRG_M1);
+            mat_vec(p, &mrg_state[stream][0], MRG_M1);
+            mat_pow(mrg_sub[1], substream, p, MRG_M2);
+            mat_vec(p, &mrg_state[stream][3], MRG_M2);
+            break;
+        case LCGRAND_XOSHIRO:
+            memcpy(xo_state[stream], xo_start[stream],
+                   sizeof(xo_state[stream]));
+            for (; substream > 0; --substream)
+                xo_jump(xo_state[stream], xo_jump_128);
+            break;
+        default:
+            ph_substream[stream] = (unsigned long long) substream;
+            ph_index[stream]     = 0;
+            ph_held[stream]      = 0;
+            break;
+    }
+    return 0;
+}
+
+
+int lcgrandbk(int new_backend) /* Select the backend. */
+{
+    if (new_backend < LCGRAND_LEGACY || new_backend > LCGRAND_PHILOX)
+        return -1;
+    backend = new_backend;
+    backend_ready();
+    return 0;
+}
+
+
+int lcgrandid(const char *name) /* Return the backend called "name." */
+{
+    static const char *names[] = {"legacy", "mrg32k3a", "xoshiro", "philox"};
+    int                i;
+
+    for (i = 0; i < 4; ++i)
+        if (strcmp(name, names[i]) == 0)
+            return i;
+    return -1;
+}
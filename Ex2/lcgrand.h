@@ -1,15 +1,32 @@
-/* The following 3 declarations are for use of the random-number generator
+/* The following declarations are for use of the random-number generator
    lcgrand and the associated functions lcgrandst and lcgrandgt for seed
-   management.  This file (named lcgrand.h) should be included in any program
-   using these functions by executing
+   management, lcgrandfl for filling arrays, lcgrandsk for skipping ahead,
+   lcgrandd and lcgrandfd for double precision, lcgrandss for substreams and
+   lcgrandbk and lcgrandid for selecting the generator behind them.  This file
+   (named lcgrand.h) should be included in any program using these functions
+   by executing
        #include "lcgrand.h"
    before referencing the functions. */
 
 #ifndef _LCGRAND_H
 #define _LCGRAND_H
 
-float lcgrand(int stream);
-void  lcgrandst(long zset, int stream);
-long  lcgrandgt(int stream);
+/* Backends, for lcgrandbk and for LCGRAND_BACKEND at compile time. */
+
+#define LCGRAND_LEGACY   0  /* Marse-Roberts LCG, the default. */
+#define LCGRAND_MRG32K3A 1  /* L'Ecuyer's MRG32k3a. */
+#define LCGRAND_XOSHIRO  2  /* xoshiro256++. */
+#define LCGRAND_PHILOX   3  /* Philox4x32-10. */
+
+float  lcgrand(int stream);
+void   lcgrandst(long zset, int stream);
+long   lcgrandgt(int stream);
+void   lcgrandfl(float u[], int n, int stream);
+void   lcgrandsk(long long n, int stream);
+double lcgrandd(int stream);
+void   lcgrandfd(double u[], int n, int stream);
+int    lcgrandss(long long substream, int stream);
+int    lcgrandbk(int backend);
+int    lcgrandid(const char *name);
 
 #endif // _LCGRAND_H
\ No newline at end of file
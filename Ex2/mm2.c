@@ -3,26 +3,67 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include "lcgrand.h"  /* Header file for random-number generator. */
 #include "pq.h"       /* Header file for linked list priority queue. */
+#include "jackson.h"  /* Header file for product-form steady state. */
+#include "trace.h"    /* Header file for trace files. */
+#include "telem.h"    /* Header file for live telemetry. */
+#include "traj.h"     /* Header file for trajectory recording. */
+#include "aout.h"     /* Header file for the background report writer. */
 
 #define Q_LIMIT  1000  /* Limit on queue length. */
 #define QUEUES      2  /* Number of queues (the 'c' in M/M/c) */
 #define BUSY        1  /* Mnemonics for server's being busy */
 #define IDLE        0  /* and idle. */
 #define REPS       10  /* Number of runs for the simulation. */
+#define MEASURES    7  /* Number of measures in the cross-check. */
+#define T_CRIT  2.262  /* t quantile (0.975) for REPS - 1 degrees of freedom. */
+#define PARAMS      3  /* Inputs with gradients: the mean interarrival time
+                          and the two mean service times. */
+#define GRADIENTS   6  /* Number of measures with gradients. */
+#define TRANSIT_LIMIT 1000  /* Limit on customers in transit, for gradients. */
+
+/* Counters and areas of both stations and the transit line after one
+   run, for its report. */
+
+typedef struct {
+    int   num_custs_delayed[QUEUES], num_in_transit_max;
+    float total_of_delays[QUEUES], area_num_in_queue[QUEUES],
+          area_server_status[QUEUES], area_num_in_transit, sim_time;
+} run_report;
 
 int    next_event_type, num_custs_delayed[QUEUES],
        num_time_max, num_in_transit_max, num_in_transit, num_events,
-       num_in_queue[QUEUES], server_status[QUEUES];
+       num_in_queue[QUEUES], server_status[QUEUES], analytic, cross_check,
+       tracing, telemetry, gradients, num_transit_ipa, trajectory;
 float  area_num_in_queue[QUEUES], area_server_status[QUEUES],
        area_num_in_transit, mean_interarrival, mean_service[QUEUES],
        min_transit_time, max_transit_time, sim_time, 
        time_arrival[QUEUES][Q_LIMIT + 1],
        time_last_event[QUEUES], 
        total_of_delays[QUEUES];
+double sum_measure[MEASURES], sum_sq_measure[MEASURES];
+unsigned long long num_events_done;
+
+/* Derivatives, for the gradients, with respect to each of the PARAMS
+   inputs: of the time of the next arrival, of the arrival time of each
+   customer in queue or in transit, of the departure time of the customer in
+   service, and of the totals of delays and of service times. */
+
+float  time_transit_ipa[TRANSIT_LIMIT], time_last_arrival;
+double d_next_arrival[PARAMS], d_arrival[QUEUES][Q_LIMIT + 1][PARAMS],
+       d_transit[TRANSIT_LIMIT][PARAMS], d_depart[QUEUES][PARAMS],
+       d_total_of_delays[QUEUES][PARAMS], d_total_of_service[QUEUES][PARAMS],
+       d_customer[PARAMS], d_last_arrival[PARAMS], num_starts_ipa[QUEUES],
+       total_of_service_ipa[QUEUES],
+       sum_gradient[GRADIENTS][PARAMS],
+       sum_sq_gradient[GRADIENTS][PARAMS];
 e_list *events; // DEVNOTE: Wonder if I could make it an array of event lists?
 FILE   *infile, *outfile;
+trace_file   trace;
+trace_column trace_arrival, trace_service[QUEUES];
+int          has_trace_service[QUEUES];
 
 void  initialize(void);
 void  timing(void);
@@ -30,18 +71,92 @@ void  arrive(int);
 void  transfer(void);
 void  depart(int);
 void  report(void);
+void  write_report(FILE *, const void *);
 void  update_time_avg_stats(int);
+int   report_analytic(void);
+void  record_measures(void);
+void  report_cross_check(void);
+void  open_trace(const char *);
+void  schedule_arrival(void);
+float service_time(int);
+void  publish_telemetry(int);
+void  record_trajectory(void);
+void  ipa_arrival(int);
+void  ipa_start(int, const double[], const double[], float);
+void  ipa_transit(float, const double[]);
+void  report_gradients(void);
+void  report_gradient_summary(void);
 float expon(float);
 float uniform(float, float);
 
 
-int main()  /* Main function. */
+int main(int argc, char *argv[])  /* Main function. */
 {
+    /* Check for the options -a (answer product-form inputs analytically),
+       -c (cross-check the simulation against the analytic values),
+       -r name (draw the random numbers from the named generator),
+       -t file (replay arrivals and service times from a trace file),
+       -m name (publish live snapshots to the shared-memory segment name),
+       -g (estimate gradients by infinitesimal perturbation analysis) and
+       -q file (record the queue lengths over time in a trajectory file). */
+
+    static const char *trajectory_name[3] = {"Queue 1", "Queue 2",
+                                             "In transit"};
+    int i;
+
+    for (i = 1; i < argc; i++) {
+        if ((strcmp(argv[i], "-r") == 0 || strcmp(argv[i], "-t") == 0 ||
+             strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "-q") == 0) &&
+            i + 1 == argc) {
+            fprintf(stderr, "Usage: mm2 [-a] [-c] [-r name] [-t file]"
+                    " [-m name] [-g] [-q file]\n");
+            exit(1);
+        }
+        if (strcmp(argv[i], "-a") == 0)
+            analytic = 1;
+        else if (strcmp(argv[i], "-c") == 0)
+            cross_check = 1;
+        else if (strcmp(argv[i], "-r") == 0) {
+            if (lcgrandbk(lcgrandid(argv[++i])) < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i], "-t") == 0)
+            open_trace(argv[++i]);
+        else if (strcmp(argv[i], "-m") == 0) {
+            if (telem_open(argv[++i], "mm2") < 0) {
+                fprintf(stderr, "Cannot create telemetry segment %s\n",
+                        argv[i]);
+                exit(1);
+            }
+            telemetry = 1;
+        }
+        else if (strcmp(argv[i], "-g") == 0)
+            gradients = 1;
+        else if (strcmp(argv[i], "-q") == 0) {
+            if (traj_open(argv[++i], 3, trajectory_name) < 0) {
+                fprintf(stderr, "Cannot create trajectory file %s\n",
+                        argv[i]);
+                exit(1);
+            }
+            trajectory = 1;
+        }
+    }
+    if (gradients && tracing) {
+        fprintf(stderr, "Gradients need generated, not traced, variates\n");
+        exit(1);
+    }
+
     /* Open input and output files. */
 
     infile  = fopen("mm2.in",  "r");
     outfile = fopen("mm2.out", "w");
 
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
     /* Specify the number of events for the timing function. */
 
     num_events = QUEUES * 2; // DEVNOTE: Re-implement rest with the QUEUES later for modularity
@@ -56,30 +171,46 @@ int main()  /* Main function. */
 
     /* Write report heading and input parameters. */
 
-    fprintf(outfile, "Tandem-server queueing system\n\n");
-    fprintf(outfile, "Mean interarrival time%16.3f minutes\n\n",
-            mean_interarrival);
-    fprintf(outfile, "Mean service time (server 1)%10.3f minutes\n\n",
-            mean_service[0]);
-    fprintf(outfile, "Mean service time (server 2)%10.3f minutes\n\n",
-            mean_service[1]);
-    fprintf(outfile, "Minimum transit time%18.3f minutes\n\n",
-            min_transit_time);
-    fprintf(outfile, "Maximum transit time%18.3f minutes\n\n",
-            max_transit_time);
-    fprintf(outfile, "Time cutoff%27d minutes\n\n", num_time_max);
+    aout_printf("Tandem-server queueing system\n\n");
+    aout_printf("Mean interarrival time%16.3f minutes\n\n",
+                mean_interarrival);
+    aout_printf("Mean service time (server 1)%10.3f minutes\n\n",
+                mean_service[0]);
+    aout_printf("Mean service time (server 2)%10.3f minutes\n\n",
+                mean_service[1]);
+    aout_printf("Minimum transit time%18.3f minutes\n\n",
+                min_transit_time);
+    aout_printf("Maximum transit time%18.3f minutes\n\n",
+                max_transit_time);
+    aout_printf("Time cutoff%27d minutes\n\n", num_time_max);
+    if (tracing)
+        aout_printf("Trace records%25llu\n\n",
+                    trace.header->num_records);
+
+    /* Inputs with a product-form steady state need no simulation in
+       analytic mode. */
+
+    if (analytic && !tracing && !gradients && report_analytic()) {
+        fclose(infile);
+        aout_close();
+        fclose(outfile);
+        free_list(events);
+        return 0;
+    }
 
     /* Loop body starts */
-    int i = 0;
-    for (; i < REPS; i++){
+    for (i = 0; i < REPS; i++){
 
         /* Initialize the simulation. */
 
         initialize();
+        if (trajectory)
+            traj_begin(i + 1, num_time_max);
 
-        /* Run the simulation while more delays are still needed. */
+        /* Run the simulation while more delays are still needed.  A trace
+           that runs out ends the run once the system empties. */
 
-        while (sim_time < num_time_max)
+        while (sim_time < num_time_max && !(tracing && is_empty(events)))
         {
             
             /* Determine the next event. */
@@ -103,18 +234,48 @@ int main()  /* Main function. */
                     depart(1);
                     break;
             }
+
+            /* Record any change in the queue lengths. */
+
+            if (trajectory)
+                record_trajectory();
+
+            /* Publish a snapshot now and then, checking the clock only
+               every TELEM_CHECK events. */
+
+            if (telemetry && (++num_events_done & (TELEM_CHECK - 1)) == 0 &&
+                telem_due())
+                publish_telemetry(i + 1);
         }
 
         /* Invoke the report generator and end the simulation. */
 
         report();
+        if (trajectory)
+            traj_end(sim_time);
+        if (cross_check)
+            record_measures();
+        if (gradients)
+            report_gradients();
 
     }
     /* End loop body */
 
+    if (cross_check)
+        report_cross_check();
+    if (gradients)
+        report_gradient_summary();
+
     fclose(infile);
+    aout_close();
     fclose(outfile);
     free_list(events);
+    if (tracing)
+        trace_close(&trace);
+    if (telemetry)
+        telem_close(sim_time, num_events_done);
+    if (trajectory)
+        traj_close();
 
     return 0;
 }
@@ -122,6 +283,8 @@ int main()  /* Main function. */
 
 void initialize(void)  /* Initialization function. */
 {
+    int i;
+
     /* Initialize the simulation clock. */
 
     sim_time = 0.0;
@@ -146,15 +309,36 @@ void initialize(void)  /* Initialization function. */
     area_num_in_transit     = 0.0;
     num_in_transit_max      = 0;
     num_in_transit          = 0;
-    
+
+    /* Initialize the derivatives. */
+
+    if (gradients) {
+        memset(d_next_arrival, 0, sizeof(d_next_arrival));
+        memset(d_depart, 0, sizeof(d_depart));
+        memset(d_total_of_delays, 0, sizeof(d_total_of_delays));
+        memset(d_total_of_service, 0, sizeof(d_total_of_service));
+        memset(num_starts_ipa, 0, sizeof(num_starts_ipa));
+        memset(total_of_service_ipa, 0, sizeof(total_of_service_ipa));
+        num_transit_ipa = 0;
+    }
+
     /* Initialize the events priority queue. */
    
     free_list(events);
     events  = new_list();
 
+    /* Start the trace, if any, again from its first record. */
+
+    if (tracing) {
+        trace_rewind(&trace_arrival);
+        for (i = 0; i < QUEUES; ++i)
+            if (has_trace_service[i])
+                trace_rewind(&trace_service[i]);
+    }
+
     /* Initialize event list with one arrival in the first queue. */
 
-    push(events, sim_time + expon(mean_interarrival), 0);
+    schedule_arrival();
 }
 
 
@@ -176,7 +360,7 @@ void timing(void)  /* Timing function. */
         
         /* The event list is empty, so stop the simulation. */
 
-        fprintf(outfile, "\nEvent list empty at time %f", sim_time);
+        aout_printf("\nEvent list empty at time %f", sim_time);
         exit(1);
     }
 
@@ -188,13 +372,18 @@ void timing(void)  /* Timing function. */
 
 void arrive(int queue_id)  /* Arrival event function. */
 {
-    float delay;
+    float delay, service;
     int queue_event_base = 2 * queue_id;
 
+    /* Find the derivative of the arrival time of this customer. */
+
+    if (gradients)
+        ipa_arrival(queue_id);
+
     /* Schedule next arrival if in first queue. */
 
     if (queue_id == 0)
-        push(events, sim_time + expon(mean_interarrival), queue_event_base);
+        schedule_arrival();
     else {
         /* We've changing a variable that impacts an area variable, so 
            update those areas first. */
@@ -221,8 +410,8 @@ void arrive(int queue_id)  /* Arrival event function. */
         {
             /* The queue has overflowed, so stop the simulation. */
 
-            fprintf(outfile, "\nOverflow of the array num_in_queue at");
-            fprintf(outfile, " time %f", sim_time);
+            aout_printf("\nOverflow of the array num_in_queue at");
+            aout_printf(" time %f", sim_time);
             exit(2);
         }
 
@@ -230,6 +419,9 @@ void arrive(int queue_id)  /* Arrival event function. */
            arriving customer at the (new) end of time_arrival. */
 
         time_arrival[queue_id][num_in_queue[queue_id]] = sim_time;
+        if (gradients)
+            memcpy(d_arrival[queue_id][num_in_queue[queue_id]], d_customer,
+                   sizeof(d_customer));
     }
 
     else
@@ -248,18 +440,27 @@ void arrive(int queue_id)  /* Arrival event function. */
 
         /* Schedule a departure from the queue. */
 
-        push(events, sim_time + expon(mean_service[queue_id]), queue_event_base + 1);
+        service = service_time(queue_id);
+        push(events, sim_time + service, queue_event_base + 1);
+        if (gradients)
+            ipa_start(queue_id, d_customer, d_customer, service);
     }
 }
 
 
 void depart(int queue_id)  /* Departure event function. */
 {
-    int   i;
-    float delay;
-    
+    int    i;
+    float  delay, service, time_transfer;
+    double d_leaving[PARAMS];
+
     int queue_event_base = queue_id * 2;
 
+    /* Keep the derivative of the departure time of the customer leaving. */
+
+    if (gradients)
+        memcpy(d_leaving, d_depart[queue_id], sizeof(d_leaving));
+
     /* Check to see whether the queue is empty. */
 
     if (num_in_queue[queue_id] == 0)
@@ -285,8 +486,17 @@ void depart(int queue_id)  /* Departure event function. */
         /* Increment the number of customers delayed, and schedule departure. */
 
         ++num_custs_delayed[queue_id];
-        
-        push(events, sim_time + expon(mean_service[queue_id]), queue_event_base + 1);
+
+        service = service_time(queue_id);
+        push(events, sim_time + service, queue_event_base + 1);
+
+        /* The customer starts service when the one leaving departs. */
+
+        if (gradients) {
+            ipa_start(queue_id, d_leaving, d_arrival[queue_id][1], service);
+            memmove(d_arrival[queue_id][1], d_arrival[queue_id][2],
+                    num_in_queue[queue_id] * sizeof(d_arrival[0][0]));
+        }
 
         /* Move each customer in queue (if any) up one place. */
 
@@ -300,8 +510,10 @@ void depart(int queue_id)  /* Departure event function. */
         if(num_in_transit > num_in_transit_max)
             num_in_transit_max = num_in_transit;
         
-        push(events, sim_time + uniform(min_transit_time, max_transit_time), 
-            queue_event_base + 2);
+        time_transfer = sim_time + uniform(min_transit_time, max_transit_time);
+        push(events, time_transfer, queue_event_base + 2);
+        if (gradients)
+            ipa_transit(time_transfer, d_leaving);
     }
 
     /* Update time-average statistical accumulators for server. */
@@ -312,25 +524,48 @@ void depart(int queue_id)  /* Departure event function. */
 
 void report(void)  /* Report generator function. */
 {
+    run_report r;
+    int        s;
+
+    /* Hand a copy of the totals to the writer. */
+
+    for (s = 0; s < QUEUES; ++s) {
+        r.num_custs_delayed[s]  = num_custs_delayed[s];
+        r.total_of_delays[s]    = total_of_delays[s];
+        r.area_num_in_queue[s]  = area_num_in_queue[s];
+        r.area_server_status[s] = area_server_status[s];
+    }
+    r.num_in_transit_max  = num_in_transit_max;
+    r.area_num_in_transit = area_num_in_transit;
+    r.sim_time            = sim_time;
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     measures of a run, on
+                                                     the writer thread. */
+{
+    const run_report *r = record;
+
     /* Compute and write estimates of desired measures of performance. */
 
-    fprintf(outfile, "\n\nAverage delay in queue (1)%12.3f minutes\n\n",
-            total_of_delays[0] / num_custs_delayed[0]);
-    fprintf(outfile, "Average delay in queue (2)%12.3f minutes\n\n",
-            total_of_delays[1] / num_custs_delayed[1]);
-    fprintf(outfile, "Average number in queue (1)%11.3f\n\n",
-            area_num_in_queue[0] / sim_time);
-    fprintf(outfile, "Average number in queue (2)%11.3f\n\n",
-            area_num_in_queue[1] / sim_time);
-    fprintf(outfile, "Server 1 utilization%18.3f\n\n",
-            area_server_status[0] / sim_time);
-    fprintf(outfile, "Server 2 utilization%18.3f\n\n",
-            area_server_status[1] / sim_time);
-    fprintf(outfile, "Average number in transit%13.3f\n\n",
-            area_num_in_transit / sim_time);
-    fprintf(outfile, "Most in transit%23.d\n\n", 
-            num_in_transit_max);
-    fprintf(outfile, "Time simulation ended%17.3f minutes\n", sim_time);
+    fprintf(out, "\n\nAverage delay in queue (1)%12.3f minutes\n\n",
+            r->total_of_delays[0] / r->num_custs_delayed[0]);
+    fprintf(out, "Average delay in queue (2)%12.3f minutes\n\n",
+            r->total_of_delays[1] / r->num_custs_delayed[1]);
+    fprintf(out, "Average number in queue (1)%11.3f\n\n",
+            r->area_num_in_queue[0] / r->sim_time);
+    fprintf(out, "Average number in queue (2)%11.3f\n\n",
+            r->area_num_in_queue[1] / r->sim_time);
+    fprintf(out, "Server 1 utilization%18.3f\n\n",
+            r->area_server_status[0] / r->sim_time);
+    fprintf(out, "Server 2 utilization%18.3f\n\n",
+            r->area_server_status[1] / r->sim_time);
+    fprintf(out, "Average number in transit%13.3f\n\n",
+            r->area_num_in_transit / r->sim_time);
+    fprintf(out, "Most in transit%23.d\n\n", r->num_in_transit_max);
+    fprintf(out, "Time simulation ended%17.3f minutes\n", r->sim_time);
 }
 
 
@@ -358,6 +593,277 @@ void update_time_avg_stats(int s)  /* Update area accumulators for
 }
 
 
+void open_trace(const char *path)  /* Map a trace file and find its
+                                      columns. */
+{
+    char name[TRACE_NAME_LEN];
+    int  i;
+
+    if (trace_open(&trace, path) < 0) {
+        fprintf(stderr, "Cannot read trace file %s\n", path);
+        exit(1);
+    }
+    if (trace_column_open(&trace, "arrival", &trace_arrival) < 0) {
+        fprintf(stderr, "Trace file %s has no arrival column\n", path);
+        exit(1);
+    }
+    for (i = 0; i < QUEUES; ++i) {
+        sprintf(name, "service%d", i + 1);
+        has_trace_service[i] =
+            trace_column_open(&trace, name, &trace_service[i]) == 0;
+    }
+    tracing = 1;
+}
+
+
+void schedule_arrival(void)  /* Schedule the next arrival to the first
+                                queue, from the trace if there is one. */
+{
+    double time;
+    float  interarrival;
+
+    if (!tracing) {
+        interarrival = expon(mean_interarrival);
+        push(events, sim_time + interarrival, 0);
+
+        /* An exponential variate is its mean times a fixed -ln(U), so its
+           derivative with respect to the mean is the variate over the
+           mean. */
+
+        if (gradients)
+            d_next_arrival[0] += interarrival / mean_interarrival;
+    }
+
+    /* Trace arrival times are absolute, and no more arrive once the trace
+       runs out. */
+
+    else if (trace_next(&trace_arrival, &time))
+        push(events, (float) time, 0);
+}
+
+
+float service_time(int queue_id)  /* Service time of the customer starting
+                                     service at queue "queue_id". */
+{
+    double time;
+
+    /* Take the next service time from the trace if it has a column for this
+       server, and generate one when the column is missing or used up. */
+
+    if (has_trace_service[queue_id] &&
+        trace_next(&trace_service[queue_id], &time))
+        return (float) time;
+    return expon(mean_service[queue_id]);
+}
+
+
+void publish_telemetry(int rep)  /* Publish the state and running averages
+                                    of replication "rep". */
+{
+    telem_value(0, "Number in queue (1)", num_in_queue[0]);
+    telem_value(1, "Number in queue (2)", num_in_queue[1]);
+    telem_value(2, "Number in transit", num_in_transit);
+    /* An average delay is 0 until a customer has been delayed, rather than
+       the NaN of 0 / 0. */
+
+    telem_value(3, "Average delay (1)", num_custs_delayed[0] == 0 ? 0.0 :
+                total_of_delays[0] / num_custs_delayed[0]);
+    telem_value(4, "Average delay (2)", num_custs_delayed[1] == 0 ? 0.0 :
+                total_of_delays[1] / num_custs_delayed[1]);
+    telem_value(5, "Average in queue (1)", area_num_in_queue[0] / sim_time);
+    telem_value(6, "Average in queue (2)", area_num_in_queue[1] / sim_time);
+    telem_value(7, "Server 1 utilization", area_server_status[0] / sim_time);
+    telem_value(8, "Server 2 utilization", area_server_status[1] / sim_time);
+    telem_value(9, "Event list size", list_size(events));
+    telem_publish(rep, sim_time, num_events_done);
+}
+
+
+void record_trajectory(void)  /* Pass the queue lengths to the trajectory
+                                 recorder, which keeps only changes. */
+{
+    traj_record(0, sim_time, num_in_queue[0]);
+    traj_record(1, sim_time, num_in_queue[1]);
+    traj_record(2, sim_time, num_in_transit);
+}
+
+
+void ipa_arrival(int queue_id)  /* Set d_customer to the derivative of the
+                                   arrival time of the customer arriving at
+                                   queue "queue_id". */
+{
+    int i;
+
+    /* An arrival to the first queue is the one scheduled last. */
+
+    if (queue_id == 0) {
+        memcpy(d_customer, d_next_arrival, sizeof(d_customer));
+        memcpy(d_last_arrival, d_next_arrival, sizeof(d_last_arrival));
+        time_last_arrival = sim_time;
+        return;
+    }
+
+    /* An arrival to the second queue comes out of transit, where it was
+       recorded with its arrival time.  The transit time does not depend on
+       the inputs, so the derivative is that of the departure from the first
+       queue. */
+
+    for (i = 0; i < num_transit_ipa; ++i)
+        if (time_transit_ipa[i] == sim_time)
+            break;
+    if (i == num_transit_ipa) {
+        aout_printf("\nLost a customer in transit at time %f", sim_time);
+        exit(2);
+    }
+    memcpy(d_customer, d_transit[i], sizeof(d_customer));
+    --num_transit_ipa;
+    time_transit_ipa[i] = time_transit_ipa[num_transit_ipa];
+    memcpy(d_transit[i], d_transit[num_transit_ipa], sizeof(d_transit[i]));
+}
+
+
+void ipa_start(int queue_id, const double d_start[], const double d_arrive[],
+               float service)  /* Propagate the derivatives through a start
+                                  of service at queue "queue_id". */
+{
+    int p, q = queue_id + 1;  /* Index of the mean service time in PARAMS. */
+
+    /* The start of service is the arrival if the server was idle and the
+       previous departure otherwise, and d_start is the derivative of
+       whichever it was.  The delay is the start less the arrival, and the
+       departure the start plus the service time, whose derivative is the
+       service time over its mean. */
+
+    for (p = 0; p < PARAMS; ++p) {
+        d_total_of_delays[queue_id][p] += d_start[p] - d_arrive[p];
+        d_depart[queue_id][p]           = d_start[p];
+    }
+    d_depart[queue_id][q]           += service / mean_service[queue_id];
+    d_total_of_service[queue_id][q] += service / mean_service[queue_id];
+    ++num_starts_ipa[queue_id];
+    total_of_service_ipa[queue_id] += service;
+}
+
+
+void ipa_transit(float time, const double d_leaving[])  /* Record the
+                                                           derivative of a
+                                                           customer going
+                                                           into transit. */
+{
+    if (num_transit_ipa == TRANSIT_LIMIT) {
+        aout_printf("\nOverflow of the array d_transit at");
+        aout_printf(" time %f", sim_time);
+        exit(2);
+    }
+    time_transit_ipa[num_transit_ipa] = time;
+    memcpy(d_transit[num_transit_ipa], d_leaving, sizeof(d_transit[0]));
+    ++num_transit_ipa;
+}
+
+
+void report_gradients(void)  /* Write the gradients of the run just reported,
+                                and add them to the sums over the runs. */
+{
+    static const char *label[GRADIENTS] = {
+        "Average delay in queue (1)", "Average delay in queue (2)",
+        "Average number in queue (1)", "Average number in queue (2)",
+        "Server 1 utilization", "Server 2 utilization" };
+    double g, m;
+    int    i, p, q;
+
+    /* The delay gradients are averages over the customers delayed.  A time
+       average m = X / T, where the area X is the total of the delays or of
+       the service times, moves with both X and the length T of the run.  T
+       is taken as the time of the last arrival, whose derivative is known,
+       so that the derivative of m is dX / T - m dT / T. */
+
+    aout_printf("\nGradient with respect to mean %13s%13s%13s\n",
+                "interarrival", "service (1)", "service (2)");
+    for (i = 0; i < GRADIENTS; ++i) {
+        aout_printf("%-30s", label[i]);
+        q = i % 2;
+        for (p = 0; p < PARAMS; ++p) {
+            if (i < 2)
+                g = d_total_of_delays[q][p] / num_starts_ipa[q];
+            else {
+                if (i < 4) {
+                    m = total_of_delays[q] / time_last_arrival;
+                    g = d_total_of_delays[q][p] / time_last_arrival;
+                }
+                else {
+                    m = total_of_service_ipa[q] / time_last_arrival;
+                    g = d_total_of_service[q][p] / time_last_arrival;
+                }
+                g -= m * d_last_arrival[p] / time_last_arrival;
+            }
+            aout_printf("%13.3f", g);
+            sum_gradient[i][p]    += g;
+            sum_sq_gradient[i][p] += g * g;
+        }
+        aout_printf("\n");
+    }
+}
+
+
+void report_gradient_summary(void)  /* Write the mean gradients over the
+                                       runs, with the exact steady-state
+                                       gradients when there are any. */
+{
+    static const char *label[GRADIENTS] = {
+        "Average delay in queue (1)", "Average delay in queue (2)",
+        "Average number in queue (1)", "Average number in queue (2)",
+        "Server 1 utilization", "Server 2 utilization" };
+    static const char *param[PARAMS] = {
+        "mean interarrival time", "mean service time (1)",
+        "mean service time (2)" };
+    jackson_station up[QUEUES], down[QUEUES];
+    float           inputs[PARAMS], h;
+    double          exact[GRADIENTS][PARAMS], mean, var, half_width;
+    int             i, p, q, stable = 1;
+
+    /* Differentiate the product-form measures numerically, by central
+       differences in each input. */
+
+    for (p = 0; p < PARAMS && stable; ++p) {
+        inputs[0] = mean_interarrival;
+        inputs[1] = mean_service[0];
+        inputs[2] = mean_service[1];
+        h = 1.0e-3 * inputs[p];
+        inputs[p] += h;
+        stable = jackson_tandem(inputs[0], &inputs[1], QUEUES, up);
+        inputs[p] -= 2 * h;
+        stable = stable && jackson_tandem(inputs[0], &inputs[1], QUEUES, down);
+        for (q = 0; q < QUEUES; ++q) {
+            exact[q][p]     = (up[q].avg_delay_in_queue -
+                               down[q].avg_delay_in_queue) / (2 * h);
+            exact[2 + q][p] = (up[q].avg_num_in_queue -
+                               down[q].avg_num_in_queue) / (2 * h);
+            exact[4 + q][p] = (up[q].utilization -
+                               down[q].utilization) / (2 * h);
+        }
+    }
+
+    for (p = 0; p < PARAMS; ++p) {
+        aout_printf("\nGradients with respect to the %s (%d runs)\n\n",
+                    param[p], REPS);
+        aout_printf("%-28s%10s%10s%10s\n", "Measure",
+                    stable ? "Exact" : "", "Mean", "+/-");
+        for (i = 0; i < GRADIENTS; ++i) {
+            mean       = sum_gradient[i][p] / REPS;
+            var        = (sum_sq_gradient[i][p] - REPS * mean * mean) /
+                         (REPS - 1);
+            half_width = T_CRIT * sqrt(var > 0.0 ? var / REPS : 0.0);
+            aout_printf("%-28s", label[i]);
+            if (stable)
+                aout_printf("%10.3f", exact[i][p]);
+            else
+                aout_printf("%10s", "");
+            aout_printf("%10.3f%10.3f\n", mean, half_width);
+        }
+    }
+}
+
+
 float expon(float mean)  /* Exponential variate generation function. */
 {
     /* Return an exponential random variate with mean "mean". */
@@ -370,4 +876,106 @@ float uniform(float min, float max)  /* Uniform variate generation function. */
     /* Return a uniformly distributed random variate between "min" and "max" */
    
     return min + ((max - min)*lcgrand(1));
-}
\ No newline at end of file
+}
+
+
+int report_analytic(void)  /* Write the exact steady-state measures of the
+                              product-form network, returning 0 (so the model
+                              is simulated instead) if a station has no
+                              steady state. */
+{
+    jackson_station station[QUEUES];
+    int             i;
+
+    if (!jackson_tandem(mean_interarrival, mean_service, QUEUES, station)) {
+        for (i = 0; i < QUEUES; i++)
+            if (!station[i].stable)
+                aout_printf("Server %d utilization %.3f has no steady"
+                            " state; simulating\n\n", i + 1,
+                            station[i].utilization);
+        return 0;
+    }
+
+    aout_printf("Steady-state (product-form) measures\n\n");
+    aout_printf("\nAverage delay in queue (1)%12.3f minutes\n\n",
+                station[0].avg_delay_in_queue);
+    aout_printf("Average delay in queue (2)%12.3f minutes\n\n",
+                station[1].avg_delay_in_queue);
+    aout_printf("Average number in queue (1)%11.3f\n\n",
+                station[0].avg_num_in_queue);
+    aout_printf("Average number in queue (2)%11.3f\n\n",
+                station[1].avg_num_in_queue);
+    aout_printf("Server 1 utilization%18.3f\n\n",
+                station[0].utilization);
+    aout_printf("Server 2 utilization%18.3f\n\n",
+                station[1].utilization);
+    aout_printf("Average number in transit%13.3f\n",
+                jackson_delay_node(mean_interarrival,
+                               (min_transit_time + max_transit_time) / 2));
+    return 1;
+}
+
+
+void record_measures(void)  /* Add the measures of the run just reported to
+                               the cross-check sums. */
+{
+    float measure[MEASURES];
+    int   i;
+
+    measure[0] = total_of_delays[0] / num_custs_delayed[0];
+    measure[1] = total_of_delays[1] / num_custs_delayed[1];
+    measure[2] = area_num_in_queue[0] / sim_time;
+    measure[3] = area_num_in_queue[1] / sim_time;
+    measure[4] = area_server_status[0] / sim_time;
+    measure[5] = area_server_status[1] / sim_time;
+    measure[6] = area_num_in_transit / sim_time;
+
+    for (i = 0; i < MEASURES; i++) {
+        sum_measure[i]    += measure[i];
+        sum_sq_measure[i] += measure[i] * measure[i];
+    }
+}
+
+
+void report_cross_check(void)  /* Compare the mean over the runs with the
+                                  exact steady-state value of each measure. */
+{
+    static const char *label[MEASURES] = {
+        "Average delay in queue (1)", "Average delay in queue (2)",
+        "Average number in queue (1)", "Average number in queue (2)",
+        "Server 1 utilization", "Server 2 utilization",
+        "Average number in transit" };
+    jackson_station station[QUEUES];
+    double          exact[MEASURES], mean, var, half_width;
+    int             i;
+
+    if (!jackson_tandem(mean_interarrival, mean_service, QUEUES, station)) {
+        aout_printf("\nNo steady state to cross-check against\n");
+        return;
+    }
+    exact[0] = station[0].avg_delay_in_queue;
+    exact[1] = station[1].avg_delay_in_queue;
+    exact[2] = station[0].avg_num_in_queue;
+    exact[3] = station[1].avg_num_in_queue;
+    exact[4] = station[0].utilization;
+    exact[5] = station[1].utilization;
+    exact[6] = jackson_delay_node(mean_interarrival,
+                                  (min_transit_time + max_transit_time) / 2);
+
+    /* Flag each measure whose exact value lies outside the 95% confidence
+       interval of the simulated mean. */
+
+    aout_printf("\nCross-check against steady state (%d runs)\n\n",
+                REPS);
+    aout_printf("%-28s%10s%10s%10s\n", "Measure", "Exact", "Mean",
+                "+/-");
+    for (i = 0; i < MEASURES; i++) {
+        mean       = sum_measure[i] / REPS;
+        var        = (sum_sq_measure[i] - REPS * mean * mean) / (REPS - 1);
+        half_width = T_CRIT * sqrt(var > 0.0 ? var / REPS : 0.0);
+        aout_printf("%-28s%10.3f%10.3f%10.3f%s\n", label[i], exact[i],
+                    mean, half_width,
+                    fabs(mean - exact[i]) > half_width ? "  *" : "");
+    }
+    aout_printf("\n* exact value outside the 95%% confidence interval\n");
+}
@@ -0,0 +1,600 @@
+/* External definitions for the tandem queueing system of mm2.c, simulated as
+   a conservative parallel discrete-event simulation.
+
+   Each station is a logical process (LP) with its own clock, state, event
+   times and random-number stream, run on its own thread.  A departure from
+   station s is sent to station s + 1 as a timestamped message over a
+   single-producer, single-consumer ring buffer.  Alongside the messages each
+   channel carries a null message in the Chandy-Misra-Bryant sense: a lower
+   bound on the timestamp of any message the sender will still send, which is
+   the sender's next event time plus the lookahead min_transit_time.  A
+   station only executes an event that lies strictly before the bound on its
+   input channel, so it never receives a message in its past.
+
+   Station s draws all of its variates (arrivals for station 0, services and
+   the transit delay to the next station) from stream s + 1, so a run depends
+   only on the inputs and not on thread timing.  Running with the option -s
+   steps the same logical processes on one thread, which gives identical
+   results. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "pq.h"       /* Header file for heap priority queue. */
+#include "aout.h"     /* Header file for the background report writer. */
+
+#define Q_LIMIT       1000  /* Limit on queue length. */
+#define QUEUES           2  /* Number of stations in the tandem line. */
+#define BUSY             1  /* Mnemonics for server's being busy */
+#define IDLE             0  /* and idle. */
+#define REPS            10  /* Number of runs for the simulation. */
+#define CHANNEL_SIZE  1024  /* Capacity of a message channel. */
+#define NEVER      1.0e+30  /* Time of an event that is not scheduled. */
+
+#define STEP_DONE      -1  /* Mnemonics for the result of lp_step: */
+#define STEP_BLOCKED    0  /* finished, waiting on the input channel, */
+#define STEP_EVENT      1  /* or one event executed. */
+
+typedef struct channel channel;
+typedef struct station station;
+
+/* Message channel from station s to station s + 1.  The ring buffer carries
+   the arrival times at station s + 1; bound carries the null message. */
+
+struct channel {
+    float         buffer[CHANNEL_SIZE];
+    atomic_uint   head, tail;
+    _Atomic float bound;
+};
+
+/* Logical process for one station. */
+
+struct station {
+    int      id, stream, done, num_in_queue, server_status,
+             num_custs_delayed, num_in_transit, num_in_transit_max;
+    long     num_events;
+    float    time_arrival[Q_LIMIT + 1], time_next_arrival,
+             time_next_departure, time_last_event, time_last_transit,
+             total_of_delays, area_num_in_queue, area_server_status,
+             area_num_in_transit;
+    e_list   *inbox;       /* Arrivals received from the previous station. */
+    e_list   *in_transit;  /* Arrival times of customers sent onward. */
+    channel  *input, *output;
+};
+
+/* Totals of every logical process after one run, for its report. */
+
+typedef struct {
+    int   num_custs_delayed[QUEUES], num_in_transit_max[QUEUES];
+    long  num_events;
+    float total_of_delays[QUEUES], area_num_in_queue[QUEUES],
+          area_server_status[QUEUES], area_num_in_transit[QUEUES];
+} run_report;
+
+int      num_time_max, sequential;
+float    mean_interarrival, mean_service[QUEUES], min_transit_time,
+         max_transit_time;
+station  stations[QUEUES];
+channel  channels[QUEUES - 1];
+FILE     *infile, *outfile;
+
+void  initialize(void);
+void  run_sequential(void);
+void  run_parallel(void);
+void *lp_run(void *);
+int   lp_step(station *);
+void  lp_finish(station *);
+void  arrive(station *, float);
+void  depart(station *);
+void  send(station *, float);
+void  publish(station *);
+int   receive(station *);
+void  update_time_avg_stats(station *, float);
+void  update_transit_stats(station *, float);
+void  report(void);
+void  write_report(FILE *, const void *);
+float expon(float, int);
+float uniform(float, float, int);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    int i;
+
+    /* Check for the option to step the logical processes on one thread. */
+
+    sequential = argc > 1 && strcmp(argv[1], "-s") == 0;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm2.in",  "r");
+    outfile = fopen("mm2cmb.out", "w");
+
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %f %f %f %d", &mean_interarrival, &(mean_service[0]),
+           &(mean_service[1]), &min_transit_time, &max_transit_time, &num_time_max);
+
+    /* Write report heading and input parameters. */
+
+    aout_printf("Tandem-server queueing system (conservative parallel)\n\n");
+    aout_printf("Mean interarrival time%16.3f minutes\n\n",
+                mean_interarrival);
+    for (i = 0; i < QUEUES; i++)
+        aout_printf("Mean service time (server %d)%10.3f minutes\n\n",
+                    i + 1, mean_service[i]);
+    aout_printf("Minimum transit time%18.3f minutes\n\n",
+                min_transit_time);
+    aout_printf("Maximum transit time%18.3f minutes\n\n",
+                max_transit_time);
+    aout_printf("Time cutoff%27d minutes\n\n", num_time_max);
+    aout_printf("Logical processes%21d (%s)\n\n", QUEUES,
+                sequential ? "one thread" : "one thread each");
+
+    /* Allocate the per-station event lists. */
+
+    for (i = 0; i < QUEUES; i++) {
+        stations[i].inbox      = new_list();
+        stations[i].in_transit = new_list();
+    }
+
+    for (i = 0; i < REPS; i++) {
+
+        /* Initialize the simulation, run it to the time cutoff, and report. */
+
+        initialize();
+        if (sequential)
+            run_sequential();
+        else
+            run_parallel();
+        report();
+    }
+
+    for (i = 0; i < QUEUES; i++) {
+        free_list(stations[i].inbox);
+        free_list(stations[i].in_transit);
+    }
+    fclose(infile);
+    aout_close();
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int      i;
+    station *lp;
+
+    for (i = 0; i < QUEUES; i++) {
+        lp = &stations[i];
+
+        /* Initialize the state variables and statistical counters. */
+
+        lp->id                  = i;
+        lp->stream              = i + 1;
+        lp->done                = 0;
+        lp->server_status       = IDLE;
+        lp->num_in_queue        = 0;
+        lp->num_custs_delayed   = 0;
+        lp->num_in_transit      = 0;
+        lp->num_in_transit_max  = 0;
+        lp->num_events          = 0;
+        lp->time_last_event     = 0.0;
+        lp->time_last_transit   = 0.0;
+        lp->total_of_delays     = 0.0;
+        lp->area_num_in_queue   = 0.0;
+        lp->area_server_status  = 0.0;
+        lp->area_num_in_transit = 0.0;
+
+        /* Empty the event lists left over from the previous run. */
+
+        while (!is_empty(lp->inbox))
+            free(pop(lp->inbox));
+        while (!is_empty(lp->in_transit))
+            free(pop(lp->in_transit));
+
+        /* Connect the channels. */
+
+        lp->input  = i > 0 ? &channels[i - 1] : NULL;
+        lp->output = i < QUEUES - 1 ? &channels[i] : NULL;
+
+        /* Only the first station sees external arrivals. */
+
+        lp->time_next_departure = NEVER;
+        lp->time_next_arrival   = i == 0 ?
+            expon(mean_interarrival, lp->stream) : NEVER;
+    }
+
+    for (i = 0; i < QUEUES - 1; i++) {
+        atomic_store(&channels[i].head, 0);
+        atomic_store(&channels[i].tail, 0);
+        atomic_store(&channels[i].bound, 0.0);
+    }
+}
+
+
+void run_sequential(void)  /* Step every logical process on this thread,
+                              one event at a time so no channel fills up. */
+{
+    int i, active;
+
+    do {
+        active = 0;
+        for (i = 0; i < QUEUES; i++)
+            if (lp_step(&stations[i]) != STEP_DONE)
+                active = 1;
+    } while (active);
+}
+
+
+void run_parallel(void)  /* Run each logical process on its own thread. */
+{
+    int       i;
+    pthread_t threads[QUEUES];
+
+    for (i = 0; i < QUEUES; i++)
+        pthread_create(&threads[i], NULL, lp_run, &stations[i]);
+    for (i = 0; i < QUEUES; i++)
+        pthread_join(threads[i], NULL);
+}
+
+
+void *lp_run(void *arg)  /* Thread body for one logical process. */
+{
+    station *lp = (station *) arg;
+    int      result;
+
+    while ((result = lp_step(lp)) != STEP_DONE)
+        if (result == STEP_BLOCKED)
+            sched_yield();
+    return NULL;
+}
+
+
+int lp_step(station *lp)  /* Execute the next safe event of a station. */
+{
+    float bound, time_arrival, time_next;
+
+    if (lp->done)
+        return STEP_DONE;
+
+    /* Read the null message before draining the channel, so every message
+       with a timestamp below the bound is already in the ring buffer. */
+
+    bound = NEVER;
+    if (lp->input != NULL) {
+        bound = atomic_load_explicit(&lp->input->bound, memory_order_acquire);
+        receive(lp);
+    }
+
+    /* Determine the next arrival.  The first station generates its own; the
+       others take the earliest message received. */
+
+    if (lp->id == 0)
+        time_arrival = lp->time_next_arrival;
+    else
+        time_arrival = is_empty(lp->inbox) ? NEVER
+                                           : get_event_time(peek(lp->inbox));
+
+    /* Arrivals go before departures at the same time. */
+
+    time_next = time_arrival <= lp->time_next_departure
+                ? time_arrival : lp->time_next_departure;
+
+    if (time_next >= num_time_max && bound >= num_time_max) {
+
+        /* Nothing is left before the time cutoff, so close the statistics
+           and release the next station for good. */
+
+        lp_finish(lp);
+        return STEP_DONE;
+    }
+
+    if (time_next >= bound || time_next >= num_time_max) {
+
+        /* An earlier message may still come, so publish this station's own
+           bound and wait for the previous station to move on. */
+
+        publish(lp);
+        return STEP_BLOCKED;
+    }
+
+    /* The event is safe, so execute it. */
+
+    ++lp->num_events;
+    if (time_arrival <= lp->time_next_departure) {
+        if (lp->id == 0)
+            lp->time_next_arrival = time_arrival +
+                                    expon(mean_interarrival, lp->stream);
+        else
+            free(pop(lp->inbox));
+        arrive(lp, time_arrival);
+    }
+    else
+        depart(lp);
+
+    publish(lp);
+    return STEP_EVENT;
+}
+
+
+void lp_finish(station *lp)  /* Close a station at the time cutoff. */
+{
+    update_time_avg_stats(lp, num_time_max);
+    if (lp->output != NULL) {
+        update_transit_stats(lp, num_time_max);
+        atomic_store_explicit(&lp->output->bound, NEVER, memory_order_release);
+    }
+    lp->done = 1;
+}
+
+
+void arrive(station *lp, float sim_time)  /* Arrival event function. */
+{
+    update_time_avg_stats(lp, sim_time);
+
+    /* Check to see whether server is busy. */
+
+    if (lp->server_status == BUSY) {
+
+        /* Server is busy, so increment number of customers in queue. */
+
+        ++lp->num_in_queue;
+
+        /* Check to see whether an overflow condition exists. */
+
+        if (lp->num_in_queue > Q_LIMIT) {
+
+            /* The queue has overflowed, so stop the simulation.  The main
+               thread is blocked in run_parallel, so this one may write. */
+
+            aout_printf("\nOverflow of the array time_arrival at");
+            aout_printf(" station %d time %f", lp->id + 1, sim_time);
+            exit(2);
+        }
+
+        lp->time_arrival[lp->num_in_queue] = sim_time;
+    }
+
+    else {
+
+        /* Server is idle, so arriving customer has a delay of zero. */
+
+        ++lp->num_custs_delayed;
+        lp->server_status = BUSY;
+
+        /* Schedule a departure from the station. */
+
+        lp->time_next_departure = sim_time +
+            expon(mean_service[lp->id], lp->stream);
+    }
+}
+
+
+void depart(station *lp)  /* Departure event function. */
+{
+    int   i;
+    float sim_time = lp->time_next_departure, time_transit_end;
+
+    update_time_avg_stats(lp, sim_time);
+
+    /* Check to see whether the queue is empty. */
+
+    if (lp->num_in_queue == 0) {
+
+        /* The queue is empty so make the server idle. */
+
+        lp->server_status       = IDLE;
+        lp->time_next_departure = NEVER;
+    }
+
+    else {
+
+        /* The queue is nonempty, so start the next customer's service. */
+
+        --lp->num_in_queue;
+        lp->total_of_delays += sim_time - lp->time_arrival[1];
+        ++lp->num_custs_delayed;
+        lp->time_next_departure = sim_time +
+            expon(mean_service[lp->id], lp->stream);
+
+        /* Move each customer in queue (if any) up one place. */
+
+        for (i = 1; i <= lp->num_in_queue; ++i)
+            lp->time_arrival[i] = lp->time_arrival[i + 1];
+    }
+
+    /* If not the last station, send the customer on to the next one. */
+
+    if (lp->output != NULL) {
+        time_transit_end = sim_time + uniform(min_transit_time,
+                                              max_transit_time, lp->stream);
+
+        /* Record the customer as in transit until it reaches the next
+           station. */
+
+        update_transit_stats(lp, sim_time);
+        ++lp->num_in_transit;
+        if (lp->num_in_transit > lp->num_in_transit_max)
+            lp->num_in_transit_max = lp->num_in_transit;
+        push(lp->in_transit, time_transit_end, 0);
+
+        send(lp, time_transit_end);
+    }
+}
+
+
+void send(station *lp, float time_message)  /* Send a message to the next
+                                              station. */
+{
+    channel *ch = lp->output;
+    unsigned tail;
+
+    /* Wait for room in the ring buffer, then append the message. */
+
+    tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    while (tail - atomic_load_explicit(&ch->head, memory_order_acquire)
+           >= CHANNEL_SIZE)
+        sched_yield();
+    ch->buffer[tail % CHANNEL_SIZE] = time_message;
+    atomic_store_explicit(&ch->tail, tail + 1, memory_order_release);
+}
+
+
+void publish(station *lp)  /* Send a null message to the next station. */
+{
+    float time_next, bound;
+
+    if (lp->output == NULL)
+        return;
+
+    /* Every later departure from this station happens no earlier than its
+       next event, and spends at least min_transit_time in transit. */
+
+    time_next = lp->time_next_departure;
+    if (lp->id == 0) {
+        if (lp->time_next_arrival < time_next)
+            time_next = lp->time_next_arrival;
+    }
+    else {
+        if (!is_empty(lp->inbox) && get_event_time(peek(lp->inbox)) < time_next)
+            time_next = get_event_time(peek(lp->inbox));
+        bound = atomic_load_explicit(&lp->input->bound, memory_order_acquire);
+        if (bound < time_next)
+            time_next = bound;
+    }
+    atomic_store_explicit(&lp->output->bound, time_next + min_transit_time,
+                          memory_order_release);
+}
+
+
+int receive(station *lp)  /* Move messages from the input channel to the
+                             station's inbox, returning how many arrived. */
+{
+    channel *ch = lp->input;
+    unsigned head, tail;
+    int      count = 0;
+
+    head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+    tail = atomic_load_explicit(&ch->tail, memory_order_acquire);
+    for (; head != tail; ++head, ++count)
+        push(lp->inbox, ch->buffer[head % CHANNEL_SIZE], 0);
+    atomic_store_explicit(&ch->head, head, memory_order_release);
+    return count;
+}
+
+
+void update_time_avg_stats(station *lp, float sim_time)  /* Update area
+                                                            accumulators for
+                                                            time-average
+                                                            statistics. */
+{
+    float time_since_last_event;
+
+    time_since_last_event = sim_time - lp->time_last_event;
+    lp->time_last_event   = sim_time;
+
+    lp->area_num_in_queue  += lp->num_in_queue  * time_since_last_event;
+    lp->area_server_status += lp->server_status * time_since_last_event;
+}
+
+
+void update_transit_stats(station *lp, float sim_time)  /* Retire the
+                                                           customers whose
+                                                           transit ended by
+                                                           sim_time. */
+{
+    e_node *en;
+    float   time_end;
+
+    while (!is_empty(lp->in_transit) &&
+           get_event_time(peek(lp->in_transit)) <= sim_time) {
+        en       = pop(lp->in_transit);
+        time_end = get_event_time(en);
+        free(en);
+        lp->area_num_in_transit += lp->num_in_transit *
+                                   (time_end - lp->time_last_transit);
+        lp->time_last_transit    = time_end;
+        --lp->num_in_transit;
+    }
+    lp->area_num_in_transit += lp->num_in_transit *
+                               (sim_time - lp->time_last_transit);
+    lp->time_last_transit    = sim_time;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    run_report r;
+    int        i;
+
+    /* Hand a copy of the totals to the writer. */
+
+    r.num_events = 0;
+    for (i = 0; i < QUEUES; i++) {
+        r.num_custs_delayed[i]   = stations[i].num_custs_delayed;
+        r.num_in_transit_max[i]  = stations[i].num_in_transit_max;
+        r.total_of_delays[i]     = stations[i].total_of_delays;
+        r.area_num_in_queue[i]   = stations[i].area_num_in_queue;
+        r.area_server_status[i]  = stations[i].area_server_status;
+        r.area_num_in_transit[i] = stations[i].area_num_in_transit;
+        r.num_events += stations[i].num_events;
+    }
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     measures of a run, on
+                                                     the writer thread. */
+{
+    const run_report *r = record;
+    int              i;
+
+    fprintf(out, "\n");
+    for (i = 0; i < QUEUES; i++)
+        fprintf(out, "\nAverage delay in queue (%d)%12.3f minutes\n",
+                i + 1, r->total_of_delays[i] / r->num_custs_delayed[i]);
+    for (i = 0; i < QUEUES; i++)
+        fprintf(out, "\nAverage number in queue (%d)%11.3f\n",
+                i + 1, r->area_num_in_queue[i] / num_time_max);
+    for (i = 0; i < QUEUES; i++)
+        fprintf(out, "\nServer %d utilization%18.3f\n",
+                i + 1, r->area_server_status[i] / num_time_max);
+    for (i = 0; i < QUEUES - 1; i++) {
+        fprintf(out, "\nAverage number in transit (%d)%9.3f\n",
+                i + 1, r->area_num_in_transit[i] / num_time_max);
+        fprintf(out, "\nMost in transit (%d)%19d\n",
+                i + 1, r->num_in_transit_max[i]);
+    }
+    fprintf(out, "\nEvents processed%22ld\n\n", r->num_events);
+}
+
+
+float expon(float mean, int stream)  /* Exponential variate generation
+                                        function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(stream));
+}
+
+
+float uniform(float min, float max, int stream)  /* Uniform variate generation
+                                                    function. */
+{
+    /* Return a uniformly distributed random variate between "min" and "max" */
+
+    return min + ((max - min) * lcgrand(stream));
+}
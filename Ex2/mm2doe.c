@@ -0,0 +1,394 @@
+/* Design-of-experiments runner for the tandem queueing system of mm2.c.
+
+   A grid of input values is expanded into design points, and every
+   replication of every point is run as one task of a work-stealing pool
+   (pool.h) within this one process, using the re-entrant form of the model
+   in mm2sim.h.  Points near saturation take far longer than light ones;
+   the tasks are dealt out in point order, so the heavy ones fall together,
+   and idle threads steal them from the busy ones.  The results go into one
+   table, with a confidence interval for each delay over the replications.
+
+   The time cutoff is read from mm2.in, whose other values are replaced by
+   the design.  mm2doe.in holds the design: its first line gives
+
+       design        0 for a full factorial, 1 for a Latin hypercube
+       replications  runs of each design point
+       threads       0 for one per processor
+       points        number of Latin hypercube points (unused otherwise)
+
+   and each of the next five lines gives the low value, high value and
+   number of levels of one factor: the mean interarrival time, the two mean
+   service times, and the minimum and maximum transit times.  A full
+   factorial takes every combination of equally spaced levels; a factor
+   with one level stays at its low value.  A Latin hypercube draws each
+   factor once from each of "points" equal strata of its range, the strata
+   matched at random across factors, and ignores the levels.
+
+   Task t (replication r of point p, t = p * replications + r) reseeds the
+   stream of the thread that takes it to a common start and runs on its
+   substream t, so every task sees the same random numbers wherever it runs,
+   and the table does not depend on the number of threads or on which
+   thread stole what.  This needs a generator with substreams; Philox is
+   used unless the option -r name selects another. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "mm2sim.h"   /* Header file for the re-entrant tandem model. */
+#include "pool.h"     /* Header file for the work-stealing pool. */
+
+#define FACTORS        5  /* Number of factors in the design. */
+#define FACTORIAL      0  /* Mnemonics for the kinds of design. */
+#define LATIN          1
+#define DESIGN_STREAM 100  /* Stream for drawing the Latin hypercube. */
+#define TASK_SEED   12345  /* Common start of the task substreams. */
+
+int        design, num_reps, num_threads, num_lhs_points, num_points,
+           num_time_max, levels[FACTORS], *status;
+float      low[FACTORS], high[FACTORS];
+mm2_params *points;
+mm2_result *results;
+pool_stats stats;
+FILE       *infile, *doefile, *outfile;
+
+void   expand_factorial(void);
+void   expand_latin(void);
+void   set_factor(mm2_params *, int factor, float value);
+void   run_task(int task, int worker, void *arg);
+void   report(double wall_seconds);
+void   mean_half_width(int point, int measure, double *mean,
+                       double *half_width);
+double t_crit(int df);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    int             i, backend = LCGRAND_PHILOX;
+    float           skip;
+    struct timespec wall_start, wall_stop;
+
+    /* Check for the option -r name (draw the random numbers from the named
+       generator). */
+
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "-r") == 0) {
+            if (i + 1 == argc) {
+                fprintf(stderr, "Usage: mm2doe [-r name]\n");
+                exit(1);
+            }
+            backend = lcgrandid(argv[++i]);
+            if (backend < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+    if (backend == LCGRAND_LEGACY) {
+        fprintf(stderr, "The runner needs a generator with substreams\n");
+        exit(1);
+    }
+    lcgrandbk(backend);
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm2.in",  "r");
+    doefile = fopen("mm2doe.in", "r");
+    outfile = fopen("mm2doe.out", "w");
+
+    /* Read input parameters: only the time cutoff of mm2.in is used. */
+
+    fscanf(infile, "%f %f %f %f %f %d", &skip, &skip, &skip, &skip, &skip,
+           &num_time_max);
+    fscanf(doefile, "%d %d %d %d", &design, &num_reps, &num_threads,
+           &num_lhs_points);
+    for (i = 0; i < FACTORS; ++i)
+        fscanf(doefile, "%f %f %d", &low[i], &high[i], &levels[i]);
+    if (num_reps < 1)
+        num_reps = 1;
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (num_threads > DESIGN_STREAM - 1)
+        num_threads = DESIGN_STREAM - 1;
+
+    /* Expand the design into points. */
+
+    if (design == LATIN)
+        expand_latin();
+    else
+        expand_factorial();
+
+    results = (mm2_result *) malloc((size_t) num_points * num_reps *
+                                    sizeof(mm2_result));
+    status  = (int *) malloc((size_t) num_points * num_reps * sizeof(int));
+    if (results == NULL || status == NULL) {
+        fprintf(outfile, "\nInsufficient memory for %d design points",
+                num_points);
+        exit(2);
+    }
+
+    /* Run every replication of every point on the pool. */
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    if (pool_run(num_points * num_reps, num_threads, run_task, NULL,
+                 &stats) < 0)
+        fprintf(stderr, "Not every thread could be started\n");
+    clock_gettime(CLOCK_MONOTONIC, &wall_stop);
+
+    /* Invoke the report generator and end the runs. */
+
+    report((wall_stop.tv_sec - wall_start.tv_sec) +
+           (wall_stop.tv_nsec - wall_start.tv_nsec) / 1.0e+9);
+
+    free(points);
+    free(results);
+    free(status);
+    fclose(infile);
+    fclose(doefile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void expand_factorial(void)  /* Form every combination of factor levels. */
+{
+    int i, j, k, index;
+
+    num_points = 1;
+    for (i = 0; i < FACTORS; ++i) {
+        if (levels[i] < 1)
+            levels[i] = 1;
+        num_points *= levels[i];
+    }
+    points = (mm2_params *) malloc(num_points * sizeof(mm2_params));
+    if (points == NULL) {
+        fprintf(outfile, "\nInsufficient memory for %d design points",
+                num_points);
+        exit(2);
+    }
+
+    /* Point j takes level (j / (product of later levels)) % levels[i] of
+       factor i, so the last factor varies fastest. */
+
+    for (j = 0; j < num_points; ++j) {
+        points[j].num_time_max = num_time_max;
+        index = j;
+        for (i = FACTORS - 1; i >= 0; --i) {
+            k      = index % levels[i];
+            index /= levels[i];
+            set_factor(&points[j], i, levels[i] == 1 ? low[i] :
+                       low[i] + (high[i] - low[i]) * k / (levels[i] - 1));
+        }
+    }
+}
+
+
+void expand_latin(void)  /* Draw a Latin hypercube of points. */
+{
+    int   i, j, k, swap, *strata;
+    float value;
+
+    num_points = num_lhs_points < 1 ? 1 : num_lhs_points;
+    points = (mm2_params *) malloc(num_points * sizeof(mm2_params));
+    strata = (int *) malloc(num_points * sizeof(int));
+    if (points == NULL || strata == NULL) {
+        fprintf(outfile, "\nInsufficient memory for %d design points",
+                num_points);
+        exit(2);
+    }
+    for (j = 0; j < num_points; ++j)
+        points[j].num_time_max = num_time_max;
+
+    /* For each factor, shuffle the strata and place point j uniformly in
+       stratum strata[j]. */
+
+    for (i = 0; i < FACTORS; ++i) {
+        for (j = 0; j < num_points; ++j)
+            strata[j] = j;
+        for (j = num_points - 1; j > 0; --j) {
+            k         = (int) (lcgrand(DESIGN_STREAM) * (j + 1));
+            swap      = strata[j];
+            strata[j] = strata[k];
+            strata[k] = swap;
+        }
+        for (j = 0; j < num_points; ++j) {
+            value = low[i] + (high[i] - low[i]) *
+                    (strata[j] + lcgrand(DESIGN_STREAM)) / num_points;
+            set_factor(&points[j], i, value);
+        }
+    }
+
+    /* Keep each transit window the right way round. */
+
+    for (j = 0; j < num_points; ++j)
+        if (points[j].min_transit_time > points[j].max_transit_time) {
+            value                     = points[j].min_transit_time;
+            points[j].min_transit_time = points[j].max_transit_time;
+            points[j].max_transit_time = value;
+        }
+
+    free(strata);
+}
+
+
+void set_factor(mm2_params *p, int factor, float value)  /* Set one factor
+                                                            of a point. */
+{
+    switch (factor) {
+        case 0:
+            p->mean_interarrival = value;
+            break;
+        case 1:
+            p->mean_service[0] = value;
+            break;
+        case 2:
+            p->mean_service[1] = value;
+            break;
+        case 3:
+            p->min_transit_time = value;
+            break;
+        case 4:
+            p->max_transit_time = value;
+            break;
+    }
+}
+
+
+void run_task(int task, int worker, void *arg)  /* Run one replication of
+                                                   one point. */
+{
+    int stream = worker + 1;
+
+    (void) arg;
+
+    /* Start the worker's stream at the task's own substream. */
+
+    lcgrandst(TASK_SEED, stream);
+    lcgrandss(task, stream);
+    status[task] = mm2_run(&points[task / num_reps], stream, &results[task]);
+}
+
+
+void report(double wall_seconds)  /* Report generator function. */
+{
+    static const char *names[] = {"Mean interarrival time",
+                                  "Mean service time (server 1)",
+                                  "Mean service time (server 2)",
+                                  "Minimum transit time",
+                                  "Maximum transit time"};
+    int    i, j, r, failed;
+    long   num_events = 0;
+    double delay[2], half_width[2];
+
+    /* Write report heading and design. */
+
+    fprintf(outfile, "Tandem-server queueing system, designed experiment\n\n");
+    fprintf(outfile, "Design%32s\n\n",
+            design == LATIN ? "Latin hypercube" : "full factorial");
+    for (i = 0; i < FACTORS; ++i)
+        fprintf(outfile, "%-28s%7.3f to%7.3f, %d levels\n", names[i],
+                low[i], high[i], design == LATIN ? num_points : levels[i]);
+    fprintf(outfile, "\nTime cutoff%27d minutes\n\n", num_time_max);
+    fprintf(outfile, "Design points%25d\n\n", num_points);
+    fprintf(outfile, "Replications per point%16d\n\n", num_reps);
+
+    /* Write one row per point.  A utilization at or above 1 marks a point
+       with no steady state, whose queues grow through the run. */
+
+    fprintf(outfile, "                                               "
+                     "  Average delay in queue        Average number"
+                     "       Utilization\n");
+    fprintf(outfile, " Point Interarr Service1 Service2  Transit range"
+                     "      (1) +-          (2) +-      (1)      (2)"
+                     "      (1)      (2)\n");
+    for (j = 0; j < num_points; ++j) {
+        for (r = 0, failed = 0; r < num_reps; ++r) {
+            failed     += status[j * num_reps + r] != 0;
+            num_events += results[j * num_reps + r].num_events;
+        }
+        mean_half_width(j, 0, &delay[0], &half_width[0]);
+        mean_half_width(j, 1, &delay[1], &half_width[1]);
+        fprintf(outfile, "%6d%9.3f%9.3f%9.3f%7.2f to%5.2f"
+                         "%9.3f%7.3f%9.3f%7.3f",
+                j + 1, points[j].mean_interarrival,
+                points[j].mean_service[0], points[j].mean_service[1],
+                points[j].min_transit_time, points[j].max_transit_time,
+                delay[0], half_width[0], delay[1], half_width[1]);
+        mean_half_width(j, 2, &delay[0], &half_width[0]);
+        mean_half_width(j, 3, &delay[1], &half_width[1]);
+        fprintf(outfile, "%9.3f%9.3f", delay[0], delay[1]);
+        mean_half_width(j, 4, &delay[0], &half_width[0]);
+        mean_half_width(j, 5, &delay[1], &half_width[1]);
+        fprintf(outfile, "%9.3f%9.3f%s\n", delay[0], delay[1],
+                failed ? "  (out of memory)" : "");
+    }
+
+    /* Write how the work was spread over the threads. */
+
+    fprintf(outfile, "\nHalf-widths are of 95%% confidence intervals over");
+    fprintf(outfile, " the replications.\n\n");
+    fprintf(outfile, "Events processed%22ld\n\n", num_events);
+    fprintf(outfile, "Threads%31d\n\n", stats.num_workers);
+    fprintf(outfile, "Tasks per thread                ");
+    for (i = 0; i < stats.num_workers; ++i)
+        fprintf(outfile, " %ld", stats.tasks[i]);
+    fprintf(outfile, "\n\nTasks stolen%26ld\n\n", stats.steals);
+    fprintf(outfile, "Wall-clock seconds%20.2f\n", wall_seconds);
+}
+
+
+void mean_half_width(int point, int measure, double *mean,
+                     double *half_width)
+    /* Mean over the replications of a point of measure 0 or 1 (delays), 2
+       or 3 (numbers in queue) or 4 or 5 (utilizations), with the half-width
+       of its confidence interval. */
+{
+    int        r;
+    double     x, sum = 0.0, sum_sq = 0.0, var;
+    mm2_result *res;
+
+    for (r = 0; r < num_reps; ++r) {
+        res = &results[point * num_reps + r];
+        switch (measure) {
+            case 0: case 1:
+                x = res->avg_delay[measure];
+                break;
+            case 2: case 3:
+                x = res->avg_num_in_queue[measure - 2];
+                break;
+            default:
+                x = res->utilization[measure - 4];
+                break;
+        }
+        sum    += x;
+        sum_sq += x * x;
+    }
+    *mean = sum / num_reps;
+    if (num_reps < 2) {
+        *half_width = 0.0;
+        return;
+    }
+    var = (sum_sq - num_reps * *mean * *mean) / (num_reps - 1);
+    *half_width = t_crit(num_reps - 1) * sqrt(var > 0.0 ? var / num_reps : 0.0);
+}
+
+
+double t_crit(int df)  /* t quantile (0.975) for df degrees of freedom. */
+{
+    static const double table[30] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+    const double z = 1.959964;
+
+    /* Beyond the table, the Cornish-Fisher expansion about the normal
+       quantile is good to three decimals. */
+
+    if (df <= 30)
+        return table[df - 1];
+    return z + (z * z * z + z) / (4.0 * df) +
+           (5 * pow(z, 5) + 16 * z * z * z + 3 * z) / (96.0 * df * df);
+}
@@ -0,0 +1,282 @@
+/* External definitions for the tandem queueing system of mm2.c, written in
+   the process-interaction style of proc.h.  Instead of arrival and departure
+   event functions over global state, each customer is a process that seizes
+   a station, holds it for its service time, releases it, and travels on to
+   the next station.  A source process generates the customers.
+
+   The processes draw variates in the same order as the event functions of
+   mm2.c, so a run follows the same sample path as mm2.c (the run end times
+   match mm2.out) unless two events fall at exactly the same time.  The time
+   averages are accumulated by the stations themselves, updated before every
+   change of state.  The report ends with the event rate, for comparison with
+   the hand-written model. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "proc.h"     /* Header file for process-interaction layer. */
+#include "aout.h"     /* Header file for the background report writer. */
+
+#define QUEUES      2  /* Number of stations in the tandem line. */
+#define REPS       10  /* Number of runs for the simulation. */
+
+/* Variables kept in the frame of a source or customer process. */
+
+typedef struct {
+    int   station;
+    float time_gap;
+} proc_vars;
+
+/* Station and transit totals of one run, for its report. */
+
+typedef struct {
+    int   num_custs_delayed[QUEUES], num_in_transit_max;
+    float total_of_delays[QUEUES], area_num_in_queue[QUEUES],
+          area_busy[QUEUES], area_num_in_transit, time_end;
+} run_report;
+
+int      num_time_max, num_in_transit, num_in_transit_max;
+float    mean_interarrival, mean_service[QUEUES], min_transit_time,
+         max_transit_time, area_num_in_transit, time_last_transit;
+resource stations[QUEUES];
+FILE     *infile, *outfile;
+
+void  initialize(void);
+int   source(process *);
+int   customer(process *);
+void  update_transit_stats(void);
+void  report(void);
+void  write_report(FILE *, const void *);
+float expon(float);
+float uniform(float, float);
+
+
+int main()  /* Main function. */
+{
+    int     i;
+    long    num_events = 0;
+    clock_t time_start;
+    double  cpu_seconds;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm2.in",  "r");
+    outfile = fopen("mm2proc.out", "w");
+
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %f %f %f %d", &mean_interarrival, &(mean_service[0]),
+           &(mean_service[1]), &min_transit_time, &max_transit_time, &num_time_max);
+
+    /* Write report heading and input parameters. */
+
+    aout_printf("Tandem-server queueing system (process interaction)\n\n");
+    aout_printf("Mean interarrival time%16.3f minutes\n\n",
+                mean_interarrival);
+    aout_printf("Mean service time (server 1)%10.3f minutes\n\n",
+                mean_service[0]);
+    aout_printf("Mean service time (server 2)%10.3f minutes\n\n",
+                mean_service[1]);
+    aout_printf("Minimum transit time%18.3f minutes\n\n",
+                min_transit_time);
+    aout_printf("Maximum transit time%18.3f minutes\n\n",
+                max_transit_time);
+    aout_printf("Time cutoff%27d minutes\n\n", num_time_max);
+
+    time_start = clock();
+    for (i = 0; i < REPS; i++) {
+
+        /* Initialize the simulation. */
+
+        initialize();
+
+        /* Run the simulation while more delays are still needed. */
+
+        while (proc_clock < num_time_max && proc_step())
+            ;
+
+        /* Invoke the report generator and end the simulation. */
+
+        report();
+        num_events += proc_events;
+    }
+    cpu_seconds = (double) (clock() - time_start) / CLOCKS_PER_SEC;
+
+    aout_printf("\nEvents processed%22ld\n\n", num_events);
+    aout_printf("Events per CPU second%17.0f\n",
+                cpu_seconds > 0.0 ? num_events / cpu_seconds : 0.0);
+
+    for (i = 0; i < QUEUES; i++)
+        res_free(&stations[i]);
+    proc_free();
+    fclose(infile);
+    aout_close();
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    static int first = 1;
+    int        i;
+
+    /* Reset the clock, the event list and the process pool. */
+
+    proc_init();
+
+    /* Initialize the stations and the transit statistics. */
+
+    for (i = 0; i < QUEUES; i++) {
+        if (!first)
+            res_free(&stations[i]);
+        res_init(&stations[i]);
+    }
+    first               = 0;
+    num_in_transit      = 0;
+    num_in_transit_max  = 0;
+    area_num_in_transit = 0.0;
+    time_last_transit   = 0.0;
+
+    /* Start the source of customers. */
+
+    proc_spawn(source);
+}
+
+
+int source(process *p)  /* Customer source process. */
+{
+    proc_vars *v = PROC_VARS(p, proc_vars);
+
+    PROC_BEGIN(p);
+
+    /* Wait for the first arrival. */
+
+    PROC_DELAY(p, expon(mean_interarrival));
+
+    for (;;) {
+
+        /* Draw the time to the next arrival before the new customer draws
+           its service time, as the arrival event of mm2.c does. */
+
+        v->time_gap = expon(mean_interarrival);
+        proc_spawn(customer);
+        PROC_DELAY(p, v->time_gap);
+    }
+
+    PROC_END(p);
+}
+
+
+int customer(process *p)  /* Customer process. */
+{
+    proc_vars *v = PROC_VARS(p, proc_vars);
+
+    PROC_BEGIN(p);
+
+    for (v->station = 0; v->station < QUEUES; ++v->station) {
+
+        /* Wait for the server, then hold it for the service time. */
+
+        PROC_SEIZE(p, &stations[v->station]);
+        PROC_DELAY(p, expon(mean_service[v->station]));
+        PROC_RELEASE(p, &stations[v->station]);
+
+        /* If not the last station, travel on to the next one. */
+
+        if (v->station < QUEUES - 1) {
+            update_transit_stats();
+            if (++num_in_transit > num_in_transit_max)
+                num_in_transit_max = num_in_transit;
+            PROC_DELAY(p, uniform(min_transit_time, max_transit_time));
+            update_transit_stats();
+            --num_in_transit;
+        }
+    }
+
+    PROC_END(p);
+}
+
+
+void update_transit_stats(void)  /* Update the area under the number-in-
+                                    transit function. */
+{
+    area_num_in_transit += num_in_transit * (proc_clock - time_last_transit);
+    time_last_transit    = proc_clock;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    run_report r;
+    int        i;
+
+    /* Bring the time averages up to the end of the run. */
+
+    for (i = 0; i < QUEUES; i++)
+        res_update(&stations[i]);
+    update_transit_stats();
+
+    /* Hand a copy of the totals to the writer. */
+
+    for (i = 0; i < QUEUES; i++) {
+        r.num_custs_delayed[i] = stations[i].num_custs_delayed;
+        r.total_of_delays[i]   = stations[i].total_of_delays;
+        r.area_num_in_queue[i] = stations[i].area_num_in_queue;
+        r.area_busy[i]         = stations[i].area_busy;
+    }
+    r.num_in_transit_max  = num_in_transit_max;
+    r.area_num_in_transit = area_num_in_transit;
+    r.time_end            = proc_clock;
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     measures of a run, on
+                                                     the writer thread. */
+{
+    const run_report *r = record;
+
+    /* Compute and write estimates of desired measures of performance. */
+
+    fprintf(out, "\n\nAverage delay in queue (1)%12.3f minutes\n\n",
+            r->total_of_delays[0] / r->num_custs_delayed[0]);
+    fprintf(out, "Average delay in queue (2)%12.3f minutes\n\n",
+            r->total_of_delays[1] / r->num_custs_delayed[1]);
+    fprintf(out, "Average number in queue (1)%11.3f\n\n",
+            r->area_num_in_queue[0] / r->time_end);
+    fprintf(out, "Average number in queue (2)%11.3f\n\n",
+            r->area_num_in_queue[1] / r->time_end);
+    fprintf(out, "Server 1 utilization%18.3f\n\n",
+            r->area_busy[0] / r->time_end);
+    fprintf(out, "Server 2 utilization%18.3f\n\n",
+            r->area_busy[1] / r->time_end);
+    fprintf(out, "Average number in transit%13.3f\n\n",
+            r->area_num_in_transit / r->time_end);
+    fprintf(out, "Most in transit%23.d\n\n", r->num_in_transit_max);
+    fprintf(out, "Time simulation ended%17.3f minutes\n", r->time_end);
+}
+
+
+float expon(float mean)  /* Exponential variate generation function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(1));
+}
+
+
+float uniform(float min, float max)  /* Uniform variate generation function. */
+{
+    /* Return a uniformly distributed random variate between "min" and "max" */
+
+    return min + ((max - min)*lcgrand(1));
+}
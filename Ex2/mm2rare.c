@@ -0,0 +1,433 @@
+/* External definitions for rare-event estimation on the tandem queueing
+   system of mm2.c.  The quantity estimated is the probability that the
+   queue at server 2 exceeds a given level during one regenerative cycle,
+   that is, between an arrival to an empty system and the next time the
+   system is empty.  The model reads mm2.in for its parameters and mm2rare.in
+   for the rare-event settings.
+
+   Three estimators are run on the same problem:
+
+   1. Plain Monte Carlo, which counts the cycles that overflow.
+
+   2. Importance sampling.  The cycles are simulated with the mean
+      interarrival time and the mean service time of server 2 swapped, which
+      makes queue 2 drift upward, and each overflow is weighted by the
+      likelihood ratio of the exponential variates drawn.  Transit delays are
+      drawn unchanged, so they carry no weight.
+
+   3. Fixed-effort multilevel splitting.  The way to the overflow level is
+      cut into stages at increasing queue-2 thresholds.  Each stage runs a
+      fixed number of trials, each started from a state saved where an
+      earlier trial first reached the previous threshold, and stops at the
+      next threshold or at the end of the cycle.  The estimate is the
+      product of the stage success fractions, and independent runs of the
+      whole procedure give its relative error.
+
+   Queue contents are counts only, since no delays are measured, so a full
+   state is a small struct that is copied when a trial is saved. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "aout.h"     /* Header file for the background report writer. */
+
+#define QUEUES            2  /* Number of stations in the tandem line. */
+#define BUSY              1  /* Mnemonics for server's being busy */
+#define IDLE              0  /* and idle. */
+#define TRANSIT_LIMIT   256  /* Limit on customers in transit. */
+#define MAX_STAGES      100  /* Limit on splitting stages. */
+#define NEVER       1.0e+30  /* Time of an event that is not scheduled. */
+
+#define CYCLE_EMPTY       0  /* Mnemonics for how a trial ended: the system */
+#define CYCLE_LEVEL       1  /* emptied, or queue 2 reached the threshold. */
+
+/* Complete state of one cycle. */
+
+typedef struct {
+    int    num_in_queue[QUEUES], server_status[QUEUES], num_in_transit;
+    float  sim_time, time_next_arrival, time_next_departure[QUEUES],
+           time_transit_end[TRANSIT_LIMIT];
+    double log_weight;   /* Log likelihood ratio of the variates drawn. */
+} cycle_state;
+
+/* One line of the results table.  The method names are string literals,
+   so only the pointer is copied. */
+
+typedef struct {
+    const char *method;
+    long       events;
+    double     p, rel_error, cpu_seconds;
+} method_report;
+
+int   level, num_cycles, num_effort, num_stages, num_split_runs, num_time_max;
+float mean_interarrival, mean_service[QUEUES], min_transit_time,
+      max_transit_time, sim_interarrival, sim_service[QUEUES];
+long  num_events;
+FILE  *infile, *outfile;
+
+void   start_cycle(cycle_state *);
+int    run_cycle(cycle_state *, int);
+void   estimate_plain(void);
+void   estimate_is(void);
+void   estimate_splitting(void);
+void   report(const char *, double, double, long, clock_t);
+void   write_report(FILE *, const void *);
+float  expon_weighted(float, float, cycle_state *);
+float  uniform(float, float);
+
+
+int main()  /* Main function. */
+{
+    FILE *rarefile;
+
+    /* Open input and output files. */
+
+    infile   = fopen("mm2.in",  "r");
+    rarefile = fopen("mm2rare.in", "r");
+    outfile  = fopen("mm2rare.out", "w");
+
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %f %f %f %d", &mean_interarrival, &(mean_service[0]),
+           &(mean_service[1]), &min_transit_time, &max_transit_time, &num_time_max);
+    fscanf(rarefile, "%d %d %d %d %d", &level, &num_cycles, &num_effort,
+           &num_stages, &num_split_runs);
+    if (num_stages > MAX_STAGES)
+        num_stages = MAX_STAGES;
+
+    /* The weighted estimator's variance needs at least two cycles. */
+
+    if (num_cycles < 2) {
+        aout_printf("Cycles (plain and weighted) must be 2 or more\n");
+        exit(1);
+    }
+
+    /* Write report heading and input parameters. */
+
+    aout_printf("Tandem-server queueing system, overflow of queue 2\n\n");
+    aout_printf("Mean interarrival time%16.3f minutes\n\n",
+                mean_interarrival);
+    aout_printf("Mean service time (server 1)%10.3f minutes\n\n",
+                mean_service[0]);
+    aout_printf("Mean service time (server 2)%10.3f minutes\n\n",
+                mean_service[1]);
+    aout_printf("Minimum transit time%18.3f minutes\n\n",
+                min_transit_time);
+    aout_printf("Maximum transit time%18.3f minutes\n\n",
+                max_transit_time);
+    aout_printf("Overflow when queue 2 exceeds%9d\n\n", level);
+    aout_printf("Cycles (plain and weighted)%11d\n\n", num_cycles);
+    aout_printf("Splitting stages%22d\n\n", num_stages);
+    aout_printf("Trials per stage%22d\n\n", num_effort);
+    aout_printf("Splitting runs%24d\n\n", num_split_runs);
+    aout_printf("%-24s%14s%12s%12s%10s\n", "Method",
+                "P(overflow)", "Rel. error", "Events", "CPU sec");
+
+    estimate_plain();
+    estimate_is();
+    estimate_splitting();
+
+    fclose(infile);
+    fclose(rarefile);
+    aout_close();
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void start_cycle(cycle_state *cs)  /* Start a cycle with an arrival to the
+                                      empty system at time 0. */
+{
+    int i;
+
+    for (i = 0; i < QUEUES; i++) {
+        cs->num_in_queue[i]        = 0;
+        cs->server_status[i]       = IDLE;
+        cs->time_next_departure[i] = NEVER;
+    }
+    cs->num_in_transit = 0;
+    cs->sim_time       = 0.0;
+    cs->log_weight     = 0.0;
+
+    /* The arriving customer goes straight into service at server 1. */
+
+    cs->time_next_arrival      = expon_weighted(sim_interarrival,
+                                                mean_interarrival, cs);
+    cs->server_status[0]       = BUSY;
+    cs->time_next_departure[0] = expon_weighted(sim_service[0],
+                                                mean_service[0], cs);
+}
+
+
+int run_cycle(cycle_state *cs, int threshold)  /* Simulate until queue 2
+                                                  reaches threshold or the
+                                                  system empties. */
+{
+    int   i, q, next_transit;
+    float time_next;
+
+    for (;;) {
+
+        /* Determine the next event: an arrival, a departure, or the end of
+           the earliest transit. */
+
+        next_transit = -1;
+        time_next    = cs->time_next_arrival;
+        for (i = 0; i < cs->num_in_transit; i++)
+            if (cs->time_transit_end[i] < time_next) {
+                time_next    = cs->time_transit_end[i];
+                next_transit = i;
+            }
+        q = -1;
+        for (i = 0; i < QUEUES; i++)
+            if (cs->time_next_departure[i] < time_next) {
+                time_next = cs->time_next_departure[i];
+                q         = i;
+            }
+        cs->sim_time = time_next;
+        ++num_events;
+
+        if (q >= 0) {
+
+            /* Departure from server q. */
+
+            if (cs->num_in_queue[q] == 0) {
+                cs->server_status[q]       = IDLE;
+                cs->time_next_departure[q] = NEVER;
+            }
+            else {
+                --cs->num_in_queue[q];
+                cs->time_next_departure[q] = cs->sim_time +
+                    expon_weighted(sim_service[q], mean_service[q], cs);
+            }
+
+            /* Send the customer on to the next station. */
+
+            if (q < QUEUES - 1) {
+                if (cs->num_in_transit == TRANSIT_LIMIT) {
+                    aout_printf("\nOverflow of the array time_transit_end");
+                    exit(2);
+                }
+                cs->time_transit_end[cs->num_in_transit++] = cs->sim_time +
+                    uniform(min_transit_time, max_transit_time);
+            }
+
+            /* Check whether the system has emptied. */
+
+            else if (cs->num_in_transit == 0) {
+                for (i = 0; i < QUEUES; i++)
+                    if (cs->server_status[i] == BUSY)
+                        break;
+                if (i == QUEUES)
+                    return CYCLE_EMPTY;
+            }
+            continue;
+        }
+
+        if (next_transit >= 0) {
+
+            /* Arrival at server 2 from transit. */
+
+            cs->time_transit_end[next_transit] =
+                cs->time_transit_end[--cs->num_in_transit];
+            q = 1;
+        }
+        else {
+
+            /* Arrival at server 1 from outside. */
+
+            cs->time_next_arrival = cs->sim_time +
+                expon_weighted(sim_interarrival, mean_interarrival, cs);
+            q = 0;
+        }
+
+        if (cs->server_status[q] == BUSY) {
+            ++cs->num_in_queue[q];
+            if (q == 1 && cs->num_in_queue[1] >= threshold)
+                return CYCLE_LEVEL;
+        }
+        else {
+            cs->server_status[q]       = BUSY;
+            cs->time_next_departure[q] = cs->sim_time +
+                expon_weighted(sim_service[q], mean_service[q], cs);
+        }
+    }
+}
+
+
+void estimate_plain(void)  /* Plain Monte Carlo estimate. */
+{
+    cycle_state cs;
+    clock_t     time_start = clock();
+    long        hits = 0;
+    int         i;
+    double      p;
+
+    sim_interarrival = mean_interarrival;
+    sim_service[0]   = mean_service[0];
+    sim_service[1]   = mean_service[1];
+    num_events       = 0;
+
+    for (i = 0; i < num_cycles; i++) {
+        start_cycle(&cs);
+        hits += run_cycle(&cs, level + 1) == CYCLE_LEVEL;
+    }
+
+    p = (double) hits / num_cycles;
+    report("Plain Monte Carlo", p,
+           hits > 0 ? sqrt((1.0 - p) / (p * num_cycles)) : -1.0,
+           num_events, time_start);
+}
+
+
+void estimate_is(void)  /* Importance-sampling estimate with the arrival
+                           and server 2 rates swapped. */
+{
+    cycle_state cs;
+    clock_t     time_start = clock();
+    int         i;
+    double      weight, sum = 0.0, sum_sq = 0.0, mean, var;
+
+    sim_interarrival = mean_service[1];
+    sim_service[0]   = mean_service[0];
+    sim_service[1]   = mean_interarrival;
+    num_events       = 0;
+
+    for (i = 0; i < num_cycles; i++) {
+        start_cycle(&cs);
+        if (run_cycle(&cs, level + 1) == CYCLE_LEVEL) {
+            weight  = exp(cs.log_weight);
+            sum    += weight;
+            sum_sq += weight * weight;
+        }
+    }
+
+    mean = sum / num_cycles;
+    var  = (sum_sq / num_cycles - mean * mean) * num_cycles / (num_cycles - 1);
+    report("Importance sampling", mean,
+           mean > 0.0 ? sqrt(var / num_cycles) / mean : -1.0,
+           num_events, time_start);
+}
+
+
+void estimate_splitting(void)  /* Fixed-effort multilevel splitting
+                                  estimate. */
+{
+    cycle_state *entrance, *reached, cs;
+    clock_t      time_start = clock();
+    int          run, stage, trial, threshold, num_entrance, num_reached;
+    double       p, sum = 0.0, sum_sq = 0.0, mean, var;
+
+    sim_interarrival = mean_interarrival;
+    sim_service[0]   = mean_service[0];
+    sim_service[1]   = mean_service[1];
+    num_events       = 0;
+
+    entrance = (cycle_state *) malloc(num_effort * sizeof(cycle_state));
+    reached  = (cycle_state *) malloc(num_effort * sizeof(cycle_state));
+
+    for (run = 0; run < num_split_runs; run++) {
+        p            = 1.0;
+        num_entrance = 0;
+
+        for (stage = 1; stage <= num_stages && p > 0.0; stage++) {
+
+            /* Thresholds are spread evenly up to one past the level. */
+
+            threshold   = (int) ceil((double) stage * (level + 1) / num_stages);
+            num_reached = 0;
+
+            for (trial = 0; trial < num_effort; trial++) {
+
+                /* The first stage starts fresh cycles; later stages restart
+                   from a state drawn from those that reached the previous
+                   threshold. */
+
+                if (stage == 1)
+                    start_cycle(&cs);
+                else
+                    cs = entrance[(int) (lcgrand(2) * num_entrance)];
+
+                if (run_cycle(&cs, threshold) == CYCLE_LEVEL)
+                    reached[num_reached++] = cs;
+            }
+
+            p *= (double) num_reached / num_effort;
+            memcpy(entrance, reached, num_reached * sizeof(cycle_state));
+            num_entrance = num_reached;
+        }
+
+        sum    += p;
+        sum_sq += p * p;
+    }
+
+    free(entrance);
+    free(reached);
+
+    mean = sum / num_split_runs;
+    var  = num_split_runs > 1
+           ? (sum_sq - num_split_runs * mean * mean) / (num_split_runs - 1)
+           : 0.0;
+    report("Multilevel splitting", mean,
+           mean > 0.0 && num_split_runs > 1
+           ? sqrt(var / num_split_runs) / mean : -1.0,
+           num_events, time_start);
+}
+
+
+void report(const char *method, double p, double rel_error, long events,
+            clock_t time_start)  /* Hand one line of the results table to
+                                    the writer. */
+{
+    method_report r;
+
+    r.method      = method;
+    r.p           = p;
+    r.rel_error   = rel_error;
+    r.events      = events;
+    r.cpu_seconds = (double) (clock() - time_start) / CLOCKS_PER_SEC;
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Write one line of the
+                                                     results table, on the
+                                                     writer thread. */
+{
+    const method_report *r = record;
+
+    fprintf(out, "%-24s%14.4e", r->method, r->p);
+    if (r->rel_error >= 0.0)
+        fprintf(out, "%12.4f", r->rel_error);
+    else
+        fprintf(out, "%12s", "n/a");
+    fprintf(out, "%12ld%10.2f\n", r->events, r->cpu_seconds);
+}
+
+
+float expon_weighted(float mean, float nominal, cycle_state *cs)
+    /* Exponential variate with mean "mean", updating the likelihood ratio
+       of the nominal mean "nominal" against it. */
+{
+    float x = -mean * log(lcgrand(1));
+
+    if (mean != nominal)
+        cs->log_weight += log((double) mean / nominal) - x / nominal + x / mean;
+    return x;
+}
+
+
+float uniform(float min, float max)  /* Uniform variate generation function. */
+{
+    /* Return a uniformly distributed random variate between "min" and "max" */
+
+    return min + ((max - min)*lcgrand(1));
+}
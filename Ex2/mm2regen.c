@@ -0,0 +1,248 @@
+/* Regenerative estimates of the steady state of the tandem queueing system
+   of mm2.c, run in parallel.
+
+   Each time an arrival finds the whole system empty, with no customer in
+   queue, in service or in transit, the system starts afresh: the
+   interarrival times are exponential, so nothing that follows depends on
+   what went before.  The run between two such arrivals is a cycle, and the
+   cycles are independent and identically distributed.  A steady-state
+   measure is then the ratio of the expected total over a cycle of its
+   numerator y (the delays in a queue, or the area under a number in queue,
+   server-busy or number-in-transit function) to that of its denominator x
+   (the number of delays, or the length of the cycle), estimated by the
+   ratio of the sums over n cycles.  By the central limit theorem for
+   ratios, its 95% confidence interval has half-width
+
+       1.96 * s / (mean of x * sqrt(n)),  s^2 = sum of (y - r x)^2 / (n - 1)
+
+   where r is the estimate.  Since every cycle starts from the empty system
+   in its steady-state law, there is no warm-up to discard.
+
+   Independent cycles need no order, so they are run as tasks of a work-
+   stealing pool (pool.h), each task running a fixed number of consecutive
+   cycles with the re-entrant form of the model (mm2sim.h) on its own
+   substream; the sums are added in task order, so the estimates do not
+   depend on the number of threads.  This needs a generator with
+   substreams; Philox is used unless the option -r name selects another.
+
+   The inputs are read from mm2.in, whose time cutoff is not used, and
+   mm2regen.in gives the number of cycles in a task, the number of tasks
+   and the number of threads, 0 for one per processor.  Cutting long cycles
+   short would bias the estimates, so inputs with no steady state, where a
+   cycle may never end, are refused. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "mm2sim.h"   /* Header file for the re-entrant tandem model. */
+#include "pool.h"     /* Header file for the work-stealing pool. */
+#include "jackson.h"  /* Header file for product-form steady state. */
+
+#define TASK_SEED 12345    /* Common start of the task substreams. */
+#define Z_CRIT    1.959964 /* Normal quantile (0.975). */
+
+int             num_tasks, num_threads, *status;
+long            num_cycles_per_task;
+mm2_params      params;
+jackson_station station[MM2_QUEUES];
+mm2_cycle_sums  *sums;
+pool_stats      stats;
+FILE            *infile, *regenfile, *outfile;
+
+void run_task(int task, int worker, void *arg);
+void report(double wall_seconds);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    int             i, backend = LCGRAND_PHILOX;
+    struct timespec wall_start, wall_stop;
+
+    /* Check for the option -r name (draw the random numbers from the named
+       generator). */
+
+    for (i = 1; i < argc; i++)
+        if (strcmp(argv[i], "-r") == 0) {
+            if (i + 1 == argc) {
+                fprintf(stderr, "Usage: mm2regen [-r name]\n");
+                exit(1);
+            }
+            backend = lcgrandid(argv[++i]);
+            if (backend < 0) {
+                fprintf(stderr, "Unknown generator %s\n", argv[i]);
+                exit(1);
+            }
+        }
+    if (backend == LCGRAND_LEGACY) {
+        fprintf(stderr, "The estimator needs a generator with substreams\n");
+        exit(1);
+    }
+    lcgrandbk(backend);
+
+    /* Open input and output files. */
+
+    infile    = fopen("mm2.in",  "r");
+    regenfile = fopen("mm2regen.in", "r");
+    outfile   = fopen("mm2regen.out", "w");
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %f %f %f %d", &params.mean_interarrival,
+           &params.mean_service[0], &params.mean_service[1],
+           &params.min_transit_time, &params.max_transit_time,
+           &params.num_time_max);
+    fscanf(regenfile, "%ld %d %d", &num_cycles_per_task, &num_tasks,
+           &num_threads);
+    if (num_cycles_per_task < 2)
+        num_cycles_per_task = 2;
+    if (num_tasks < 1)
+        num_tasks = 1;
+    if (num_threads <= 0)
+        num_threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (!jackson_tandem(params.mean_interarrival, params.mean_service,
+                        MM2_QUEUES, station)) {
+        fprintf(outfile, "No steady state: a server has utilization");
+        fprintf(outfile, " 1 or more\n");
+        exit(1);
+    }
+
+    sums   = (mm2_cycle_sums *) calloc(num_tasks, sizeof(mm2_cycle_sums));
+    status = (int *) malloc(num_tasks * sizeof(int));
+    if (sums == NULL || status == NULL) {
+        fprintf(outfile, "\nInsufficient memory for %d tasks", num_tasks);
+        exit(2);
+    }
+
+    /* Run the cycles on the pool. */
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+    if (pool_run(num_tasks, num_threads, run_task, NULL, &stats) < 0)
+        fprintf(stderr, "Not every thread could be started\n");
+    clock_gettime(CLOCK_MONOTONIC, &wall_stop);
+
+    /* Invoke the report generator and end the runs. */
+
+    report((wall_stop.tv_sec - wall_start.tv_sec) +
+           (wall_stop.tv_nsec - wall_start.tv_nsec) / 1.0e+9);
+
+    free(sums);
+    free(status);
+    fclose(infile);
+    fclose(regenfile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void run_task(int task, int worker, void *arg)  /* Run one task's cycles. */
+{
+    int stream = worker + 1;
+
+    (void) arg;
+
+    /* Start the worker's stream at the task's own substream. */
+
+    lcgrandst(TASK_SEED, stream);
+    lcgrandss(task, stream);
+    status[task] = mm2_cycles(&params, stream, num_cycles_per_task,
+                              &sums[task]);
+}
+
+
+void report(double wall_seconds)  /* Report generator function. */
+{
+    static const char *label[MM2_MEASURES] = {
+        "Average delay in queue (1)", "Average delay in queue (2)",
+        "Average number in queue (1)", "Average number in queue (2)",
+        "Server 1 utilization", "Server 2 utilization",
+        "Average number in transit" };
+    mm2_cycle_sums total;
+    double         exact[MM2_MEASURES], r, var, half_width;
+    long           n;
+    int            i, k, failed = 0;
+
+    /* Add the tasks' sums in task order. */
+
+    memset(&total, 0, sizeof(total));
+    for (i = 0; i < num_tasks; ++i) {
+        failed           += status[i] != 0;
+        total.num_cycles += sums[i].num_cycles;
+        total.num_events += sums[i].num_events;
+        for (k = 0; k < MM2_MEASURES; ++k) {
+            total.sum_y[k]  += sums[i].sum_y[k];
+            total.sum_x[k]  += sums[i].sum_x[k];
+            total.sum_yy[k] += sums[i].sum_yy[k];
+            total.sum_xx[k] += sums[i].sum_xx[k];
+            total.sum_xy[k] += sums[i].sum_xy[k];
+        }
+    }
+    n = total.num_cycles;
+
+    /* The product-form values, to compare with. */
+
+    for (k = 0; k < MM2_QUEUES; ++k) {
+        exact[k]     = station[k].avg_delay_in_queue;
+        exact[2 + k] = station[k].avg_num_in_queue;
+        exact[4 + k] = station[k].utilization;
+    }
+    exact[6] = jackson_delay_node(params.mean_interarrival,
+                                  (params.min_transit_time +
+                                   params.max_transit_time) / 2);
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Tandem-server queueing system, regenerative cycles\n\n");
+    fprintf(outfile, "Mean interarrival time%16.3f minutes\n\n",
+            params.mean_interarrival);
+    fprintf(outfile, "Mean service time (server 1)%10.3f minutes\n\n",
+            params.mean_service[0]);
+    fprintf(outfile, "Mean service time (server 2)%10.3f minutes\n\n",
+            params.mean_service[1]);
+    fprintf(outfile, "Minimum transit time%18.3f minutes\n\n",
+            params.min_transit_time);
+    fprintf(outfile, "Maximum transit time%18.3f minutes\n\n",
+            params.max_transit_time);
+    fprintf(outfile, "Cycles%32ld\n\n", n);
+    if (failed) {
+        fprintf(outfile, "%d of %d tasks ran out of memory\n\n", failed,
+                num_tasks);
+    }
+    if (n < 2) {
+        fprintf(outfile, "Too few cycles for an estimate\n");
+        return;
+    }
+    fprintf(outfile, "Mean cycle length%21.3f minutes\n\n",
+            total.sum_x[2] / n);
+
+    /* Write each ratio estimate with its confidence interval. */
+
+    fprintf(outfile, "%-28s%10s%10s%10s\n", "Measure", "Estimate", "+/-",
+            "Exact");
+    for (k = 0; k < MM2_MEASURES; ++k) {
+        r   = total.sum_y[k] / total.sum_x[k];
+        var = (total.sum_yy[k] - 2 * r * total.sum_xy[k] +
+               r * r * total.sum_xx[k]) / (n - 1);
+        half_width = Z_CRIT * sqrt(var > 0.0 ? var / n : 0.0) /
+                     (total.sum_x[k] / n);
+        fprintf(outfile, "%-28s%10.3f%10.3f%10.3f%s\n", label[k], r,
+                half_width, exact[k],
+                fabs(r - exact[k]) > half_width ? "  *" : "");
+    }
+    fprintf(outfile, "\n* exact value outside the 95%% confidence"
+                     " interval\n");
+
+    /* Write how the work was spread over the threads. */
+
+    fprintf(outfile, "\nEvents processed%22ld\n\n", total.num_events);
+    fprintf(outfile, "Threads%31d\n\n", stats.num_workers);
+    fprintf(outfile, "Tasks per thread                ");
+    for (i = 0; i < stats.num_workers; ++i)
+        fprintf(outfile, " %ld", stats.tasks[i]);
+    fprintf(outfile, "\n\nTasks stolen%26ld\n\n", stats.steals);
+    fprintf(outfile, "Wall-clock seconds%20.2f\n", wall_seconds);
+}
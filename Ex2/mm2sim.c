@@ -0,0 +1,263 @@
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"
+#include "pq.h"
+#include "mm2sim.h"
+
+#define BUSY           1
+#define IDLE           0
+#define QUEUE_INITIAL 64    // Initial capacity of each queue.
+
+// State of one run.
+typedef struct {
+    const mm2_params *p;
+    int    stream;
+    e_list *events;
+    float  sim_time;
+    int    server_status[MM2_QUEUES], num_in_queue[MM2_QUEUES];
+    int    num_custs_delayed[MM2_QUEUES], num_in_transit, num_in_transit_max;
+    float  total_of_delays[MM2_QUEUES], area_num_in_queue[MM2_QUEUES],
+           area_server_status[MM2_QUEUES], area_num_in_transit,
+           time_last_event[MM2_QUEUES];
+
+    // Arrival times of the customers in each queue, as a ring that doubles
+    // when full.
+    float  *time_arrival[MM2_QUEUES];
+    int    head[MM2_QUEUES], capacity[MM2_QUEUES];
+} run_state;
+
+static float expon(run_state *s, float mean){
+    return -mean * log(lcgrand(s->stream));
+}
+
+static float uniform(run_state *s, float min, float max){
+    return min + ((max - min) * lcgrand(s->stream));
+}
+
+// Add an arrival time at the back of queue q.  Return 0, or -1 if the queue
+// cannot grow.
+static int enqueue(run_state *s, int q, float time){
+    int   i, n = s->num_in_queue[q], cap = s->capacity[q];
+    float *grown;
+
+    if (n == cap){
+        grown = malloc(2 * cap * sizeof(float));
+        if (grown == NULL)
+            return -1;
+        for (i = 0; i < n; i++)
+            grown[i] = s->time_arrival[q][(s->head[q] + i) % cap];
+        free(s->time_arrival[q]);
+        s->time_arrival[q] = grown;
+        s->head[q]         = 0;
+        s->capacity[q]     = 2 * cap;
+    }
+    s->time_arrival[q][(s->head[q] + n) % s->capacity[q]] = time;
+    return 0;
+}
+
+// Remove and return the arrival time at the front of queue q.
+static float dequeue(run_state *s, int q){
+    float time = s->time_arrival[q][s->head[q]];
+
+    s->head[q] = (s->head[q] + 1) % s->capacity[q];
+    return time;
+}
+
+// Update the area accumulators of station q.
+static void update_time_avg_stats(run_state *s, int q){
+    float time_since_last_event = s->sim_time - s->time_last_event[q];
+
+    s->time_last_event[q]    = s->sim_time;
+    s->area_num_in_queue[q] += s->num_in_queue[q] * time_since_last_event;
+    s->area_num_in_transit  += s->num_in_transit * time_since_last_event;
+    s->area_server_status[q] += s->server_status[q] * time_since_last_event;
+}
+
+// Arrival at station q, as arrive() of mm2.c.
+static int arrive(run_state *s, int q){
+    if (q == 0)
+        push(s->events, s->sim_time + expon(s, s->p->mean_interarrival), 0);
+    else {
+        update_time_avg_stats(s, q);
+        s->num_in_transit--;
+    }
+
+    if (s->server_status[q] == BUSY){
+        if (enqueue(s, q, s->sim_time) < 0)
+            return -1;
+        ++s->num_in_queue[q];
+    }
+    else {
+        ++s->num_custs_delayed[q];
+        s->server_status[q] = BUSY;
+        push(s->events, s->sim_time + expon(s, s->p->mean_service[q]),
+             2 * q + 1);
+    }
+    return 0;
+}
+
+// Departure from station q, as depart() of mm2.c.
+static void depart(run_state *s, int q){
+    if (s->num_in_queue[q] == 0)
+        s->server_status[q] = IDLE;
+    else {
+        --s->num_in_queue[q];
+        s->total_of_delays[q] += s->sim_time - dequeue(s, q);
+        ++s->num_custs_delayed[q];
+        push(s->events, s->sim_time + expon(s, s->p->mean_service[q]),
+             2 * q + 1);
+    }
+
+    if (q == 0){
+        s->num_in_transit++;
+        if (s->num_in_transit > s->num_in_transit_max)
+            s->num_in_transit_max = s->num_in_transit;
+        push(s->events, s->sim_time + uniform(s, s->p->min_transit_time,
+                                              s->p->max_transit_time), 2);
+    }
+
+    update_time_avg_stats(s, q);
+}
+
+// Run the model with inputs p on random-number stream "stream", and store
+// its measures in r.  Return 0, or -1 if memory runs out.
+int mm2_run(const mm2_params *p, int stream, mm2_result *r){
+    run_state s = {0};
+    e_node    *event;
+    int       q, type, status = 0;
+
+    s.p      = p;
+    s.stream = stream;
+    s.events = new_list();
+    for (q = 0; q < MM2_QUEUES; q++){
+        s.capacity[q]     = QUEUE_INITIAL;
+        s.time_arrival[q] = malloc(QUEUE_INITIAL * sizeof(float));
+        if (s.time_arrival[q] == NULL)
+            status = -1;
+    }
+    r->num_events = 0;
+
+    push(s.events, s.sim_time + expon(&s, p->mean_interarrival), 0);
+
+    while (status == 0 && s.sim_time < p->num_time_max && !is_empty(s.events)){
+        event      = pop(s.events);
+        type       = get_event_type(event);
+        s.sim_time = get_event_time(event);
+        free(event);
+        r->num_events++;
+
+        if (type % 2 == 0)
+            status = arrive(&s, type / 2);
+        else
+            depart(&s, type / 2);
+    }
+
+    for (q = 0; q < MM2_QUEUES; q++){
+        r->avg_delay[q]        = s.total_of_delays[q] / s.num_custs_delayed[q];
+        r->avg_num_in_queue[q] = s.area_num_in_queue[q] / s.sim_time;
+        r->utilization[q]      = s.area_server_status[q] / s.sim_time;
+        free(s.time_arrival[q]);
+    }
+    r->avg_num_in_transit = s.area_num_in_transit / s.sim_time;
+    r->num_in_transit_max = s.num_in_transit_max;
+    r->time_end           = s.sim_time;
+    free_list(s.events);
+    return status;
+}
+
+// Add a cycle's numerator y and denominator x of measure k to the sums.
+static void add_cycle(mm2_cycle_sums *c, int k, double y, double x){
+    c->sum_y[k]  += y;
+    c->sum_x[k]  += x;
+    c->sum_yy[k] += y * y;
+    c->sum_xx[k] += x * x;
+    c->sum_xy[k] += x * y;
+}
+
+// Run num_cycles regenerative cycles of the model with inputs p on stream
+// "stream", and add their sums to c.  A cycle starts with an arrival that
+// finds the whole system empty, transit included: interarrival times being
+// exponential, what follows is then independent of what went before, so
+// the clock restarts at zero.  The areas are taken over every change of
+// state, and the time cutoff of p is not used.  Return 0, or -1 if memory
+// runs out.  Without a steady state a cycle may never end, so the caller
+// should check for one first.
+int mm2_cycles(const mm2_params *p, int stream, long num_cycles,
+               mm2_cycle_sums *c){
+    run_state s = {0};
+    e_node    *event;
+    int       q, type, status = 0;
+    long      done = -1;        // Cycles completed, -1 before the first.
+    float     time;
+    double    time_since_last_event, area_queue[MM2_QUEUES],
+              area_busy[MM2_QUEUES], area_transit = 0.0;
+
+    s.p      = p;
+    s.stream = stream;
+    s.events = new_list();
+    for (q = 0; q < MM2_QUEUES; q++){
+        s.capacity[q]     = QUEUE_INITIAL;
+        s.time_arrival[q] = malloc(QUEUE_INITIAL * sizeof(float));
+        if (s.time_arrival[q] == NULL)
+            status = -1;
+        area_queue[q] = area_busy[q] = 0.0;
+    }
+
+    push(s.events, expon(&s, p->mean_interarrival), 0);
+
+    while (status == 0 && !is_empty(s.events)){
+        event = pop(s.events);
+        type  = get_event_type(event);
+        time  = get_event_time(event);
+        free(event);
+        c->num_events++;
+
+        if (type == 0 && s.server_status[0] == IDLE &&
+            s.server_status[1] == IDLE && s.num_in_transit == 0){
+
+            // A regeneration: close the cycle now ending, if any, and start
+            // the next at time zero.
+            if (done >= 0){
+                for (q = 0; q < MM2_QUEUES; q++){
+                    add_cycle(c, q, s.total_of_delays[q],
+                              s.num_custs_delayed[q]);
+                    add_cycle(c, 2 + q, area_queue[q], time);
+                    add_cycle(c, 4 + q, area_busy[q], time);
+                }
+                add_cycle(c, 6, area_transit, time);
+                c->num_cycles++;
+            }
+            if (++done == num_cycles)
+                break;
+            for (q = 0; q < MM2_QUEUES; q++){
+                s.total_of_delays[q]   = 0.0;
+                s.num_custs_delayed[q] = 0;
+                s.time_last_event[q]   = 0.0;
+                area_queue[q] = area_busy[q] = 0.0;
+            }
+            area_transit = 0.0;
+            s.sim_time   = 0.0;
+        }
+        else {
+
+            // The state has held since the last event.
+            time_since_last_event = time - s.sim_time;
+            for (q = 0; q < MM2_QUEUES; q++){
+                area_queue[q] += s.num_in_queue[q] * time_since_last_event;
+                area_busy[q]  += s.server_status[q] * time_since_last_event;
+            }
+            area_transit += s.num_in_transit * time_since_last_event;
+            s.sim_time    = time;
+        }
+
+        if (type % 2 == 0)
+            status = arrive(&s, type / 2);
+        else
+            depart(&s, type / 2);
+    }
+
+    for (q = 0; q < MM2_QUEUES; q++)
+        free(s.time_arrival[q]);
+    free_list(s.events);
+    return status;
+}
@@ -0,0 +1,53 @@
+#ifndef _MM2SIM_H
+#define _MM2SIM_H
+
+/*
+ * The following declarations are used for running the tandem model of
+ * mm2.c as a function.  All the state of a run lives in the run itself, so
+ * any number of runs may go on at once on different threads, each drawing
+ * its random numbers from its own stream.  The event logic, including the
+ * order in which variates are drawn and statistics accumulated, is that of
+ * mm2.c, so a run on stream 1 of the legacy generator reproduces the first
+ * replication of mm2.out.  Queues grow as needed instead of overflowing.
+ */
+
+#define MM2_QUEUES 2
+
+// Inputs of a run, as read from mm2.in.
+typedef struct {
+    float mean_interarrival;
+    float mean_service[MM2_QUEUES];
+    float min_transit_time, max_transit_time;
+    int   num_time_max;
+} mm2_params;
+
+// Measures reported for a run.
+typedef struct {
+    float avg_delay[MM2_QUEUES];
+    float avg_num_in_queue[MM2_QUEUES];
+    float utilization[MM2_QUEUES];
+    float avg_num_in_transit;
+    int   num_in_transit_max;
+    float time_end;
+    long  num_events;        // Events processed, a measure of the work.
+} mm2_result;
+
+// Sums over regenerative cycles for the ratio estimators of the measures:
+// the delays in queue (1) and (2), the numbers in queue (1) and (2), the
+// utilizations (1) and (2) and the number in transit.  The numerator y of
+// a measure in a cycle is its total of delays or its area, and the
+// denominator x the number of delays or the length of the cycle.
+#define MM2_MEASURES 7
+
+typedef struct {
+    long   num_cycles;
+    long   num_events;
+    double sum_y[MM2_MEASURES], sum_x[MM2_MEASURES];
+    double sum_yy[MM2_MEASURES], sum_xx[MM2_MEASURES], sum_xy[MM2_MEASURES];
+} mm2_cycle_sums;
+
+int mm2_run(const mm2_params*, int stream, mm2_result*);
+int mm2_cycles(const mm2_params*, int stream, long num_cycles,
+               mm2_cycle_sums*);
+
+#endif // _MM2SIM_H
@@ -0,0 +1,149 @@
+/* Timing of specialized forms of the tandem queueing system of mm2.c
+   against the runtime-configured one.
+
+   The runtime form is mm2_run (mm2sim.h), with a general event list and
+   dispatch on event type.  The specialized forms are instances of the
+   template mm2tmpl.h, fixed at compile time to two stations, exponential
+   service and uniform transit: one keeps every statistic, and one leaves
+   out those of the number in transit.  Each form runs RUNS replications of
+   the inputs in mm2.in on stream 1, from the same seed, and the report
+   gives its wall-clock time and rate of events, and checks that it gives
+   the same results as the runtime form, measure by measure. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "mm2sim.h"   /* Header file for the re-entrant tandem model. */
+
+#define RUNS     200  /* Replications of each form. */
+#define FORMS      3  /* Number of forms compared. */
+
+/* The specialized forms. */
+
+#define MM2T_NAME           run_specialized
+#define MM2T_STATIONS       2
+#define MM2T_SERVICE(m, s)  MM2T_EXPON(m, s)
+#define MM2T_TRANSIT(a, b, s) MM2T_UNIFORM(a, b, s)
+#define MM2T_TRANSIT_STATS  1
+#include "mm2tmpl.h"
+
+#define MM2T_NAME           run_lean
+#define MM2T_STATIONS       2
+#define MM2T_SERVICE(m, s)  MM2T_EXPON(m, s)
+#define MM2T_TRANSIT(a, b, s) MM2T_UNIFORM(a, b, s)
+#define MM2T_TRANSIT_STATS  0
+#include "mm2tmpl.h"
+
+typedef int (*run_form)(const mm2_params *, int, mm2_result *);
+
+mm2_params params;
+mm2_result results[FORMS][RUNS];
+FILE       *infile, *outfile;
+
+int same_results(int form);
+
+
+int main(void)  /* Main function. */
+{
+    static const char *name[FORMS] = {"Runtime (mm2_run)",
+                                      "Specialized",
+                                      "Specialized, no transit stats"};
+    static const run_form run[FORMS] = {mm2_run, run_specialized, run_lean};
+    int             form, k;
+    long            seed, num_events;
+    double          seconds[FORMS];
+    struct timespec wall_start, wall_stop;
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm2.in",  "r");
+    outfile = fopen("mm2spec.out", "w");
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %f %f %f %d", &params.mean_interarrival,
+           &params.mean_service[0], &params.mean_service[1],
+           &params.min_transit_time, &params.max_transit_time,
+           &params.num_time_max);
+
+    /* Write report heading and input parameters. */
+
+    fprintf(outfile, "Tandem-server queueing system, specialized forms\n\n");
+    fprintf(outfile, "Mean interarrival time%16.3f minutes\n\n",
+            params.mean_interarrival);
+    fprintf(outfile, "Mean service time (server 1)%10.3f minutes\n\n",
+            params.mean_service[0]);
+    fprintf(outfile, "Mean service time (server 2)%10.3f minutes\n\n",
+            params.mean_service[1]);
+    fprintf(outfile, "Minimum transit time%18.3f minutes\n\n",
+            params.min_transit_time);
+    fprintf(outfile, "Maximum transit time%18.3f minutes\n\n",
+            params.max_transit_time);
+    fprintf(outfile, "Time cutoff%27d minutes\n\n", params.num_time_max);
+    fprintf(outfile, "Replications of each form%13d\n\n", RUNS);
+
+    /* Run every form from the same seed, or from the start of the same
+       substream for a generator without seeds. */
+
+    seed = lcgrandgt(1);
+    for (form = 0; form < FORMS; ++form) {
+        if (seed >= 0)
+            lcgrandst(seed, 1);
+        else
+            lcgrandss(0, 1);
+        clock_gettime(CLOCK_MONOTONIC, &wall_start);
+        for (k = 0; k < RUNS; ++k)
+            if (run[form](&params, 1, &results[form][k]) < 0) {
+                fprintf(outfile, "\nInsufficient memory in run %d", k + 1);
+                exit(2);
+            }
+        clock_gettime(CLOCK_MONOTONIC, &wall_stop);
+        seconds[form] = (wall_stop.tv_sec - wall_start.tv_sec) +
+                        (wall_stop.tv_nsec - wall_start.tv_nsec) / 1.0e+9;
+    }
+
+    /* Write one row per form. */
+
+    fprintf(outfile, "%-30s%10s%14s%10s%10s\n", "Form", "Seconds",
+            "Events/sec", "Speedup", "Results");
+    for (form = 0; form < FORMS; ++form) {
+        for (k = 0, num_events = 0; k < RUNS; ++k)
+            num_events += results[form][k].num_events;
+        fprintf(outfile, "%-30s%10.3f%14.0f%10.2f%10s\n", name[form],
+                seconds[form], num_events / seconds[form],
+                seconds[0] / seconds[form],
+                same_results(form) ? "same" : "DIFFER");
+    }
+
+    fclose(infile);
+    fclose(outfile);
+
+    return 0;
+}
+
+
+int same_results(int form)  /* Check that a form's results equal those of
+                               the runtime form, leaving out the number in
+                               transit where the form does not keep it. */
+{
+    mm2_result *a, *b;
+    int        k, q;
+
+    for (k = 0; k < RUNS; ++k) {
+        a = &results[0][k];
+        b = &results[form][k];
+        for (q = 0; q < MM2_QUEUES; ++q)
+            if (a->avg_delay[q] != b->avg_delay[q] ||
+                a->avg_num_in_queue[q] != b->avg_num_in_queue[q] ||
+                a->utilization[q] != b->utilization[q])
+                return 0;
+        if (a->time_end != b->time_end || a->num_events != b->num_events)
+            return 0;
+        if (b->num_in_transit_max != 0 &&
+            (a->avg_num_in_transit != b->avg_num_in_transit ||
+             a->num_in_transit_max != b->num_in_transit_max))
+            return 0;
+    }
+    return 1;
+}
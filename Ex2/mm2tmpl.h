@@ -0,0 +1,349 @@
+/*
+ * The following is a template for specialized forms of the tandem model of
+ * mm2sim.c.  An instance is made by defining its parameters and including
+ * this file:
+ *
+ *     MM2T_NAME           name of the run function to define
+ *     MM2T_STATIONS       number of stations, 1 or 2; with 2, customers
+ *                         leaving station 1 pass through transit to
+ *                         station 2
+ *     MM2T_SERVICE(mean, stream)      service-time variate
+ *     MM2T_TRANSIT(min, max, stream)  transit-time variate
+ *     MM2T_TRANSIT_STATS  1 to keep the number-in-transit statistics, 0 to
+ *                         leave them out
+ *
+ * The function defined is static, with the arguments and result of
+ * mm2_run, and the parameters are undefined again at the end, so the file
+ * may be included once for each instance.  With two stations, exponential
+ * service and uniform transit, an instance draws its variates and breaks
+ * ties between events exactly as mm2_run does, and so gives the same
+ * results.
+ *
+ * Where mm2_run keeps every event in a general event list and dispatches on
+ * its type, an instance keeps the arrival and the departure from each
+ * station in fixed slots and picks the next event from them with a loop of
+ * constant length, which the compiler unrolls, so that only customers in
+ * transit, whose number has no bound, go into a heap.  Station arrays have
+ * constant size, the variates are expanded in place, and statistics left
+ * out are not computed at all.
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "lcgrand.h"
+#include "mm2sim.h"
+
+#ifndef _MM2TMPL_COMMON
+#define _MM2TMPL_COMMON
+
+#define MM2T_BUSY     1
+#define MM2T_IDLE     0
+#define MM2T_INITIAL 64    // Initial capacity of each queue and the heap.
+
+// Variates, as drawn by mm2sim.c.
+#define MM2T_EXPON(mean, stream) \
+    ((float) (-(mean) * log(lcgrand(stream))))
+#define MM2T_UNIFORM(min, max, stream) \
+    ((float) ((min) + (((max) - (min)) * lcgrand(stream))))
+
+// Check whether an event at time a, scheduled as number sa, is due before
+// one at time b scheduled as number sb.  Events at equal times are served
+// in the order they were scheduled, as in pq.c.
+#define MM2T_BEFORE(a, sa, b, sb) ((a) < (b) || ((a) == (b) && (sa) < (sb)))
+
+// Arrival times of the customers in a queue, as a ring that doubles when
+// full.
+typedef struct {
+    float *time;
+    int   head, size, capacity;
+} mm2t_queue;
+
+// Times at which customers in transit arrive, as a binary heap.
+typedef struct {
+    float         *time;
+    unsigned long *seq;
+    int           size, capacity;
+} mm2t_heap;
+
+// Add time at the back of a queue.  Return 0, or -1 if it cannot grow.
+static int mm2t_enqueue(mm2t_queue *qu, float time){
+    int   i;
+    float *grown;
+
+    if (qu->size == qu->capacity){
+        grown = malloc(2 * qu->capacity * sizeof(float));
+        if (grown == NULL)
+            return -1;
+        for (i = 0; i < qu->size; i++)
+            grown[i] = qu->time[(qu->head + i) % qu->capacity];
+        free(qu->time);
+        qu->time      = grown;
+        qu->head      = 0;
+        qu->capacity *= 2;
+    }
+    qu->time[(qu->head + qu->size++) % qu->capacity] = time;
+    return 0;
+}
+
+// Remove and return the time at the front of a queue.
+static float mm2t_dequeue(mm2t_queue *qu){
+    float time = qu->time[qu->head];
+
+    qu->head = (qu->head + 1) % qu->capacity;
+    qu->size--;
+    return time;
+}
+
+// Add an arrival from transit at time, scheduled as number seq.  Return 0,
+// or -1 if the heap cannot grow.
+static int mm2t_push(mm2t_heap *h, float time, unsigned long seq){
+    int           pos, parent;
+    float         *grown_time;
+    unsigned long *grown_seq;
+
+    if (h->size == h->capacity){
+        grown_time = realloc(h->time, 2 * h->capacity * sizeof(float));
+        if (grown_time == NULL)
+            return -1;
+        h->time = grown_time;
+        grown_seq = realloc(h->seq, 2 * h->capacity * sizeof(unsigned long));
+        if (grown_seq == NULL)
+            return -1;
+        h->seq       = grown_seq;
+        h->capacity *= 2;
+    }
+    for (pos = h->size++; pos > 0; pos = parent){
+        parent = (pos - 1) / 2;
+        if (!MM2T_BEFORE(time, seq, h->time[parent], h->seq[parent]))
+            break;
+        h->time[pos] = h->time[parent];
+        h->seq[pos]  = h->seq[parent];
+    }
+    h->time[pos] = time;
+    h->seq[pos]  = seq;
+    return 0;
+}
+
+// Remove the first arrival from transit.
+static void mm2t_pop(mm2t_heap *h){
+    int           pos = 0, child;
+    float         time = h->time[--h->size];
+    unsigned long seq  = h->seq[h->size];
+
+    for (;;){
+        child = 2 * pos + 1;
+        if (child >= h->size)
+            break;
+        if (child + 1 < h->size &&
+            MM2T_BEFORE(h->time[child + 1], h->seq[child + 1],
+                        h->time[child], h->seq[child]))
+            child++;
+        if (!MM2T_BEFORE(h->time[child], h->seq[child], time, seq))
+            break;
+        h->time[pos] = h->time[child];
+        h->seq[pos]  = h->seq[child];
+        pos = child;
+    }
+    h->time[pos] = time;
+    h->seq[pos]  = seq;
+}
+
+#endif // _MM2TMPL_COMMON
+
+#if MM2T_STATIONS < 1 || MM2T_STATIONS > MM2_QUEUES
+#error "MM2T_STATIONS must be 1 or 2"
+#endif
+
+// Run the instance with inputs p on random-number stream "stream", and
+// store its measures in r.  Return 0, or -1 if memory runs out.
+static int MM2T_NAME(const mm2_params *p, int stream, mm2_result *r){
+    float         sim_time = 0.0, time_next_arrival, time_next,
+                  time_since_last_event, time_depart[MM2T_STATIONS],
+                  time_last_event[MM2T_STATIONS],
+                  total_of_delays[MM2T_STATIONS],
+                  area_num_in_queue[MM2T_STATIONS],
+                  area_server_status[MM2T_STATIONS];
+    unsigned long seq = 0, seq_next_arrival, seq_next,
+                  seq_depart[MM2T_STATIONS];
+    int           server_status[MM2T_STATIONS],
+                  num_custs_delayed[MM2T_STATIONS], q, next, status = 0;
+    mm2t_queue    queue[MM2T_STATIONS];
+#if MM2T_STATIONS > 1
+    mm2t_heap     transit;
+#endif
+#if MM2T_STATIONS > 1 && MM2T_TRANSIT_STATS
+    float         area_num_in_transit = 0.0;
+    int           num_in_transit = 0, num_in_transit_max = 0;
+#endif
+
+    for (q = 0; q < MM2T_STATIONS; q++){
+        server_status[q]      = MM2T_IDLE;
+        num_custs_delayed[q]  = 0;
+        time_last_event[q]    = 0.0;
+        total_of_delays[q]    = 0.0;
+        area_num_in_queue[q]  = 0.0;
+        area_server_status[q] = 0.0;
+        queue[q].head = queue[q].size = 0;
+        queue[q].capacity = MM2T_INITIAL;
+        queue[q].time     = malloc(MM2T_INITIAL * sizeof(float));
+        if (queue[q].time == NULL)
+            status = -1;
+    }
+#if MM2T_STATIONS > 1
+    transit.size     = 0;
+    transit.capacity = MM2T_INITIAL;
+    transit.time     = malloc(MM2T_INITIAL * sizeof(float));
+    transit.seq      = malloc(MM2T_INITIAL * sizeof(unsigned long));
+    if (transit.time == NULL || transit.seq == NULL)
+        status = -1;
+#endif
+    r->num_events = 0;
+
+    time_next_arrival = sim_time + MM2T_EXPON(p->mean_interarrival, stream);
+    seq_next_arrival  = seq++;
+
+// Update the area accumulators of station q, as update_time_avg_stats of
+// mm2sim.c.
+#if MM2T_STATIONS > 1 && MM2T_TRANSIT_STATS
+#define MM2T_UPDATE(q)                                                      \
+    do {                                                                    \
+        time_since_last_event  = sim_time - time_last_event[q];             \
+        time_last_event[q]     = sim_time;                                  \
+        area_num_in_queue[q]  += queue[q].size * time_since_last_event;     \
+        area_num_in_transit   += num_in_transit * time_since_last_event;    \
+        area_server_status[q] += server_status[q] * time_since_last_event;  \
+    } while (0)
+#else
+#define MM2T_UPDATE(q)                                                      \
+    do {                                                                    \
+        time_since_last_event  = sim_time - time_last_event[q];             \
+        time_last_event[q]     = sim_time;                                  \
+        area_num_in_queue[q]  += queue[q].size * time_since_last_event;     \
+        area_server_status[q] += server_status[q] * time_since_last_event;  \
+    } while (0)
+#endif
+
+// A customer joins station q, starting service if the server is idle.
+#define MM2T_JOIN(q)                                                        \
+    do {                                                                    \
+        if (server_status[q] == MM2T_BUSY){                                 \
+            if (mm2t_enqueue(&queue[q], sim_time) < 0)                      \
+                status = -1;                                                \
+        }                                                                   \
+        else {                                                              \
+            ++num_custs_delayed[q];                                         \
+            server_status[q] = MM2T_BUSY;                                   \
+            time_depart[q]   = sim_time +                                   \
+                               MM2T_SERVICE(p->mean_service[q], stream);    \
+            seq_depart[q]    = seq++;                                       \
+        }                                                                   \
+    } while (0)
+
+    while (status == 0 && sim_time < p->num_time_max){
+
+        // Pick the next event: -1 for an arrival, q for a departure from
+        // station q, or MM2T_STATIONS for the end of a transit.
+        next      = -1;
+        time_next = time_next_arrival;
+        seq_next  = seq_next_arrival;
+        for (q = 0; q < MM2T_STATIONS; q++)
+            if (server_status[q] == MM2T_BUSY &&
+                MM2T_BEFORE(time_depart[q], seq_depart[q], time_next,
+                            seq_next)){
+                next      = q;
+                time_next = time_depart[q];
+                seq_next  = seq_depart[q];
+            }
+#if MM2T_STATIONS > 1
+        if (transit.size > 0 &&
+            MM2T_BEFORE(transit.time[0], transit.seq[0], time_next,
+                        seq_next)){
+            next      = MM2T_STATIONS;
+            time_next = transit.time[0];
+        }
+#endif
+        sim_time = time_next;
+        r->num_events++;
+
+        if (next < 0){
+
+            // An arrival to station 1, which schedules the next.
+            time_next_arrival = sim_time +
+                                MM2T_EXPON(p->mean_interarrival, stream);
+            seq_next_arrival  = seq++;
+            MM2T_JOIN(0);
+        }
+#if MM2T_STATIONS > 1
+        else if (next == MM2T_STATIONS){
+
+            // An arrival to station 2 from transit.
+            mm2t_pop(&transit);
+            MM2T_UPDATE(1);
+#if MM2T_TRANSIT_STATS
+            num_in_transit--;
+#endif
+            MM2T_JOIN(1);
+        }
+#endif
+        else {
+
+            // A departure from station "next", after which the head of its
+            // queue, if any, starts service.
+            q = next;
+            if (queue[q].size == 0)
+                server_status[q] = MM2T_IDLE;
+            else {
+                total_of_delays[q] += sim_time - mm2t_dequeue(&queue[q]);
+                ++num_custs_delayed[q];
+                time_depart[q] = sim_time +
+                                 MM2T_SERVICE(p->mean_service[q], stream);
+                seq_depart[q]  = seq++;
+            }
+#if MM2T_STATIONS > 1
+            if (q == 0){
+#if MM2T_TRANSIT_STATS
+                if (++num_in_transit > num_in_transit_max)
+                    num_in_transit_max = num_in_transit;
+#endif
+                if (mm2t_push(&transit, sim_time +
+                              MM2T_TRANSIT(p->min_transit_time,
+                                           p->max_transit_time, stream),
+                              seq++) < 0)
+                    status = -1;
+            }
+#endif
+            MM2T_UPDATE(q);
+        }
+    }
+
+#undef MM2T_UPDATE
+#undef MM2T_JOIN
+
+    for (q = 0; q < MM2T_STATIONS; q++){
+        r->avg_delay[q]        = total_of_delays[q] / num_custs_delayed[q];
+        r->avg_num_in_queue[q] = area_num_in_queue[q] / sim_time;
+        r->utilization[q]      = area_server_status[q] / sim_time;
+        free(queue[q].time);
+    }
+    for (; q < MM2_QUEUES; q++)
+        r->avg_delay[q] = r->avg_num_in_queue[q] = r->utilization[q] = 0.0;
+#if MM2T_STATIONS > 1 && MM2T_TRANSIT_STATS
+    r->avg_num_in_transit = area_num_in_transit / sim_time;
+    r->num_in_transit_max = num_in_transit_max;
+#else
+    r->avg_num_in_transit = 0.0;
+    r->num_in_transit_max = 0;
+#endif
+#if MM2T_STATIONS > 1
+    free(transit.time);
+    free(transit.seq);
+#endif
+    r->time_end = sim_time;
+    return status;
+}
+
+#undef MM2T_NAME
+#undef MM2T_STATIONS
+#undef MM2T_SERVICE
+#undef MM2T_TRANSIT
+#undef MM2T_TRANSIT_STATS
@@ -0,0 +1,747 @@
+/* External definitions for the tandem queueing system of mm2.c, simulated as
+   an optimistic (Time Warp) parallel discrete-event simulation.
+
+   Each station is a logical process (LP) on its own thread, with the same
+   decomposition as mm2cmb.c: station s draws all of its variates from stream
+   s + 1, and departures travel to station s + 1 as timestamped messages over
+   a single-producer, single-consumer ring buffer.  Unlike mm2cmb.c, a
+   station does not wait for its input channel to promise that no earlier
+   message is coming.  It executes its next event speculatively, saving its
+   state (including its random-number seed) before every event.
+
+   When a straggler arrives (a message timestamped at or before an event the
+   station has already executed), the station rolls back: it restores the
+   state saved before the first affected event, puts the messages those
+   events consumed back in its inbox, and sends an anti-message for every
+   message those events sent.  An anti-message annihilates its positive
+   message, rolling the receiver back first if it has already consumed it.
+
+   Every GVT_INTERVAL events the stations meet at a barrier and compute the
+   global virtual time (GVT), the smallest time any station could still
+   execute or roll back to.  State saved before GVT is never needed again, so
+   it is committed and reclaimed (fossil collection).  Transit statistics are
+   accumulated at commit time, since they never roll back.  The run ends once
+   GVT passes the time cutoff.
+
+   Because rollback restores each station exactly, the results are identical
+   to mm2cmb.c for the same inputs. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include "lcgrand.h"  /* Header file for random-number generator. */
+#include "pq.h"       /* Header file for heap priority queue. */
+#include "aout.h"     /* Header file for the background report writer. */
+
+#define Q_LIMIT          1000  /* Limit on queue length. */
+#define QUEUES              2  /* Number of stations in the tandem line. */
+#define BUSY                1  /* Mnemonics for server's being busy */
+#define IDLE                0  /* and idle. */
+#define ARRIVAL             0  /* Mnemonics for the kind of event */
+#define DEPARTURE           1  /* a snapshot was saved for. */
+#define REPS               10  /* Number of runs for the simulation. */
+#define NEVER         1.0e+30  /* Time of an event that is not scheduled. */
+#define GVT_INTERVAL      256  /* Events per station between GVT rounds. */
+#define SNAPSHOTS        8192  /* Saved states per station (power of 2). */
+#define QUEUE_LOG       32768  /* Arrival-time log entries (power of 2). */
+#define MESSAGES        32768  /* Capacity of a channel, and of the map of
+                                  unconsumed messages (power of 2). */
+
+typedef struct message  message;
+typedef struct channel  channel;
+typedef struct state    state;
+typedef struct snapshot snapshot;
+typedef struct station  station;
+
+/* Message from station s to station s + 1.  The id is the sender's count of
+   messages sent before this one, and is the same when an event is rolled
+   back and executed again. */
+
+struct message {
+    float time;
+    int   id, anti;
+};
+
+/* Message channel from station s to station s + 1.  Besides the ring buffer,
+   the receiver publishes how many of the sender's messages it has consumed
+   and committed, which throttles the sender. */
+
+struct channel {
+    message     buffer[MESSAGES];
+    atomic_uint head, tail;
+    atomic_int  committed;
+};
+
+/* The part of a station's state that is saved and restored.  Customers
+   waiting in queue are entries q_head + 1 through q_tail of the station's
+   arrival-time log. */
+
+struct state {
+    int   server_status, num_custs_delayed, num_sent;
+    long  q_head, q_tail, seed;
+    float time_next_arrival, time_next_departure, time_last_event,
+          total_of_delays, area_num_in_queue, area_server_status;
+};
+
+/* State saved before an event, with the messages the event consumed and
+   sent.  A time of NEVER marks a message that does not exist. */
+
+struct snapshot {
+    float   time;
+    int     kind;
+    message consumed, sent;
+    state   before;
+};
+
+/* Logical process for one station. */
+
+struct station {
+    int       id, stream, num_in_transit, num_in_transit_max, num_committed;
+    long      num_events, num_rolled_back, snap_head, snap_tail;
+    state     now;
+    float     q_log[QUEUE_LOG], time_last_transit, area_num_in_transit;
+    snapshot  snapshots[SNAPSHOTS];
+    e_list    *inbox;              /* Unconsumed messages, keyed by id. */
+    e_node    *pending[MESSAGES];  /* Inbox handle of each unconsumed id. */
+    e_list    *in_transit;         /* Arrival times of committed sends. */
+    channel   *input, *output;
+};
+
+/* Committed totals of every logical process after one run, for its
+   report. */
+
+typedef struct {
+    int   num_custs_delayed[QUEUES], num_in_transit_max[QUEUES];
+    long  num_events, num_rolled_back;
+    float total_of_delays[QUEUES], area_num_in_queue[QUEUES],
+          area_server_status[QUEUES], area_num_in_transit[QUEUES];
+} run_report;
+
+int               num_time_max;
+float             mean_interarrival, mean_service[QUEUES], min_transit_time,
+                  max_transit_time, local_min[2][QUEUES];
+station           stations[QUEUES];
+channel           channels[QUEUES - 1];
+pthread_barrier_t gvt_barrier;
+FILE              *infile, *outfile;
+
+void  initialize(void);
+void  run_parallel(void);
+void *lp_run(void *);
+int   lp_ready(station *);
+float lp_next_time(station *);
+void  lp_execute(station *);
+void  lp_finish(station *);
+void  arrive(station *, float);
+float depart(station *);
+void  send(station *, message);
+void  receive(station *);
+void  rollback(station *, float);
+void  fossil_collect(station *, float);
+void  update_time_avg_stats(station *, float);
+void  update_transit_stats(station *, float);
+void  report(void);
+void  write_report(FILE *, const void *);
+float expon(float, int);
+float uniform(float, float, int);
+
+
+int main()  /* Main function. */
+{
+    int i;
+
+    /* Rollback restores a station's stream from the seed lcgrandgt saved,
+       and only the legacy generator keeps its state in a seed. */
+
+    if (lcgrandgt(1) < 0) {
+        fprintf(stderr, "Rollback needs the legacy generator\n");
+        exit(1);
+    }
+
+    /* Open input and output files. */
+
+    infile  = fopen("mm2.in",  "r");
+    outfile = fopen("mm2tw.out", "w");
+
+    /* Start the background report writer. */
+
+    aout_open(outfile);
+
+    /* Read input parameters. */
+
+    fscanf(infile, "%f %f %f %f %f %d", &mean_interarrival, &(mean_service[0]),
+           &(mean_service[1]), &min_transit_time, &max_transit_time, &num_time_max);
+
+    /* Write report heading and input parameters. */
+
+    aout_printf("Tandem-server queueing system (optimistic parallel)\n\n");
+    aout_printf("Mean interarrival time%16.3f minutes\n\n",
+                mean_interarrival);
+    for (i = 0; i < QUEUES; i++)
+        aout_printf("Mean service time (server %d)%10.3f minutes\n\n",
+                    i + 1, mean_service[i]);
+    aout_printf("Minimum transit time%18.3f minutes\n\n",
+                min_transit_time);
+    aout_printf("Maximum transit time%18.3f minutes\n\n",
+                max_transit_time);
+    aout_printf("Time cutoff%27d minutes\n\n", num_time_max);
+    aout_printf("Logical processes%21d (one thread each)\n\n", QUEUES);
+
+    /* Allocate the per-station event lists and the GVT barrier. */
+
+    for (i = 0; i < QUEUES; i++) {
+        stations[i].inbox      = new_list();
+        stations[i].in_transit = new_list();
+    }
+    pthread_barrier_init(&gvt_barrier, NULL, QUEUES);
+
+    for (i = 0; i < REPS; i++) {
+
+        /* Initialize the simulation, run it to the time cutoff, and report. */
+
+        initialize();
+        run_parallel();
+        report();
+    }
+
+    pthread_barrier_destroy(&gvt_barrier);
+    for (i = 0; i < QUEUES; i++) {
+        free_list(stations[i].inbox);
+        free_list(stations[i].in_transit);
+    }
+    fclose(infile);
+    aout_close();
+    fclose(outfile);
+
+    return 0;
+}
+
+
+void initialize(void)  /* Initialization function. */
+{
+    int      i, j;
+    station *lp;
+
+    for (i = 0; i < QUEUES; i++) {
+        lp = &stations[i];
+
+        /* Initialize the state variables and statistical counters. */
+
+        lp->id                      = i;
+        lp->stream                  = i + 1;
+        lp->num_in_transit          = 0;
+        lp->num_in_transit_max      = 0;
+        lp->num_committed           = 0;
+        lp->num_events              = 0;
+        lp->num_rolled_back         = 0;
+        lp->snap_head               = 0;
+        lp->snap_tail               = 0;
+        lp->time_last_transit       = 0.0;
+        lp->area_num_in_transit     = 0.0;
+        lp->now.server_status       = IDLE;
+        lp->now.num_custs_delayed   = 0;
+        lp->now.num_sent            = 0;
+        lp->now.q_head              = 0;
+        lp->now.q_tail              = 0;
+        lp->now.time_last_event     = 0.0;
+        lp->now.total_of_delays     = 0.0;
+        lp->now.area_num_in_queue   = 0.0;
+        lp->now.area_server_status  = 0.0;
+
+        /* Empty the event lists left over from the previous run. */
+
+        while (!is_empty(lp->inbox))
+            free(pop(lp->inbox));
+        while (!is_empty(lp->in_transit))
+            free(pop(lp->in_transit));
+        for (j = 0; j < MESSAGES; j++)
+            lp->pending[j] = NULL;
+
+        /* Connect the channels. */
+
+        lp->input  = i > 0 ? &channels[i - 1] : NULL;
+        lp->output = i < QUEUES - 1 ? &channels[i] : NULL;
+
+        /* Only the first station sees external arrivals. */
+
+        lp->now.time_next_departure = NEVER;
+        lp->now.time_next_arrival   = i == 0 ?
+            expon(mean_interarrival, lp->stream) : NEVER;
+    }
+
+    for (i = 0; i < QUEUES - 1; i++) {
+        atomic_store(&channels[i].head, 0);
+        atomic_store(&channels[i].tail, 0);
+        atomic_store(&channels[i].committed, 0);
+    }
+}
+
+
+void run_parallel(void)  /* Run each logical process on its own thread. */
+{
+    int       i;
+    pthread_t threads[QUEUES];
+
+    for (i = 0; i < QUEUES; i++)
+        pthread_create(&threads[i], NULL, lp_run, &stations[i]);
+    for (i = 0; i < QUEUES; i++)
+        pthread_join(threads[i], NULL);
+}
+
+
+void *lp_run(void *arg)  /* Thread body for one logical process. */
+{
+    station *lp = (station *) arg;
+    int      i, k, round;
+    float    gvt;
+
+    for (round = 0; ; round++) {
+
+        /* Execute events optimistically until the next GVT round is due, or
+           until nothing is left to do before the time cutoff. */
+
+        for (k = 0; k < GVT_INTERVAL; k++) {
+            if (lp->input != NULL)
+                receive(lp);
+            if (!lp_ready(lp))
+                break;
+            lp_execute(lp);
+        }
+
+        /* Wait until every station has stopped sending, take in whatever is
+           still in the input channel, and publish the earliest time this
+           station could still execute.  The values are double-buffered by
+           round, so a fast station cannot overwrite them while a slow one is
+           still reading. */
+
+        pthread_barrier_wait(&gvt_barrier);
+        if (lp->input != NULL)
+            receive(lp);
+        local_min[round & 1][lp->id] = lp_next_time(lp);
+        pthread_barrier_wait(&gvt_barrier);
+
+        /* Compute GVT, and commit everything before it. */
+
+        gvt = NEVER;
+        for (i = 0; i < QUEUES; i++)
+            if (local_min[round & 1][i] < gvt)
+                gvt = local_min[round & 1][i];
+        fossil_collect(lp, gvt);
+
+        if (gvt >= num_time_max)
+            break;
+    }
+
+    lp_finish(lp);
+    return NULL;
+}
+
+
+int lp_ready(station *lp)  /* Check whether a station may execute its next
+                              event now. */
+{
+    /* Hold back when the saved states or the receiver's map of unconsumed
+       messages would fill up before the next GVT round. */
+
+    if (lp->snap_tail - lp->snap_head >= SNAPSHOTS - 1)
+        return 0;
+    if (lp->output != NULL &&
+        lp->now.num_sent - atomic_load(&lp->output->committed) >= MESSAGES / 2)
+        return 0;
+
+    return lp_next_time(lp) < num_time_max;
+}
+
+
+float lp_next_time(station *lp)  /* Return the time of a station's next
+                                    event. */
+{
+    float time_next = lp->now.time_next_departure;
+
+    if (lp->id == 0) {
+        if (lp->now.time_next_arrival <= time_next)
+            time_next = lp->now.time_next_arrival;
+    }
+    else if (!is_empty(lp->inbox) &&
+             get_event_time(peek(lp->inbox)) <= time_next)
+        time_next = get_event_time(peek(lp->inbox));
+    return time_next;
+}
+
+
+void lp_execute(station *lp)  /* Save the state, then execute the next
+                                 event. */
+{
+    snapshot *sp = &lp->snapshots[lp->snap_tail & (SNAPSHOTS - 1)];
+    e_node   *en;
+    float     time_arrival;
+
+    /* Save the state before the event. */
+
+    lp->now.seed      = lcgrandgt(lp->stream);
+    sp->before        = lp->now;
+    sp->consumed.time = NEVER;
+    sp->sent.time     = NEVER;
+    ++lp->snap_tail;
+
+    /* Arrivals go before departures at the same time. */
+
+    if (lp->id == 0)
+        time_arrival = lp->now.time_next_arrival;
+    else
+        time_arrival = is_empty(lp->inbox) ? NEVER
+                                           : get_event_time(peek(lp->inbox));
+
+    if (time_arrival <= lp->now.time_next_departure) {
+        sp->time = time_arrival;
+        sp->kind = ARRIVAL;
+        if (lp->id == 0)
+            lp->now.time_next_arrival = time_arrival +
+                                        expon(mean_interarrival, lp->stream);
+        else {
+
+            /* Consume the earliest message in the inbox. */
+
+            en                = pop(lp->inbox);
+            sp->consumed.time = time_arrival;
+            sp->consumed.id   = get_event_type(en);
+            sp->consumed.anti = 0;
+            lp->pending[sp->consumed.id & (MESSAGES - 1)] = NULL;
+            free(en);
+        }
+        arrive(lp, time_arrival);
+    }
+
+    else {
+        sp->time = lp->now.time_next_departure;
+        sp->kind = DEPARTURE;
+        sp->sent.time = depart(lp);
+
+        /* If not the last station, send the customer on to the next one. */
+
+        if (sp->sent.time < NEVER) {
+            sp->sent.id   = lp->now.num_sent++;
+            sp->sent.anti = 0;
+            send(lp, sp->sent);
+        }
+    }
+}
+
+
+void lp_finish(station *lp)  /* Close a station at the time cutoff. */
+{
+    update_time_avg_stats(lp, num_time_max);
+    if (lp->output != NULL)
+        update_transit_stats(lp, num_time_max);
+}
+
+
+void arrive(station *lp, float sim_time)  /* Arrival event function. */
+{
+    update_time_avg_stats(lp, sim_time);
+
+    /* Check to see whether server is busy. */
+
+    if (lp->now.server_status == BUSY) {
+
+        /* Server is busy, so add the customer to the queue. */
+
+        ++lp->now.q_tail;
+
+        /* Check to see whether an overflow condition exists. */
+
+        if (lp->now.q_tail - lp->now.q_head > Q_LIMIT) {
+
+            /* The queue has overflowed, so stop the simulation.  Only the
+               main thread, now joining this one, otherwise writes. */
+
+            aout_printf("\nOverflow of the array q_log at");
+            aout_printf(" station %d time %f", lp->id + 1, sim_time);
+            exit(2);
+        }
+
+        lp->q_log[lp->now.q_tail & (QUEUE_LOG - 1)] = sim_time;
+    }
+
+    else {
+
+        /* Server is idle, so arriving customer has a delay of zero. */
+
+        ++lp->now.num_custs_delayed;
+        lp->now.server_status = BUSY;
+
+        /* Schedule a departure from the station. */
+
+        lp->now.time_next_departure = sim_time +
+            expon(mean_service[lp->id], lp->stream);
+    }
+}
+
+
+float depart(station *lp)  /* Departure event function.  Returns the time
+                              the customer reaches the next station, or
+                              NEVER after the last station. */
+{
+    float sim_time = lp->now.time_next_departure;
+
+    update_time_avg_stats(lp, sim_time);
+
+    /* Check to see whether the queue is empty. */
+
+    if (lp->now.q_tail == lp->now.q_head) {
+
+        /* The queue is empty so make the server idle. */
+
+        lp->now.server_status       = IDLE;
+        lp->now.time_next_departure = NEVER;
+    }
+
+    else {
+
+        /* The queue is nonempty, so start the next customer's service.  The
+           log entry stays behind in case the event is rolled back. */
+
+        ++lp->now.q_head;
+        lp->now.total_of_delays += sim_time -
+                                   lp->q_log[lp->now.q_head & (QUEUE_LOG - 1)];
+        ++lp->now.num_custs_delayed;
+        lp->now.time_next_departure = sim_time +
+            expon(mean_service[lp->id], lp->stream);
+    }
+
+    if (lp->output == NULL)
+        return NEVER;
+    return sim_time + uniform(min_transit_time, max_transit_time, lp->stream);
+}
+
+
+void send(station *lp, message msg)  /* Send a message or anti-message to
+                                        the next station. */
+{
+    channel *ch = lp->output;
+    unsigned tail;
+
+    /* The throttle in lp_ready keeps the ring buffer from filling, so the
+       message can be appended right away. */
+
+    tail = atomic_load_explicit(&ch->tail, memory_order_relaxed);
+    ch->buffer[tail % MESSAGES] = msg;
+    atomic_store_explicit(&ch->tail, tail + 1, memory_order_release);
+}
+
+
+void receive(station *lp)  /* Take in the messages waiting on the input
+                              channel, rolling back where needed. */
+{
+    channel  *ch = lp->input;
+    message   msg;
+    e_node   *en;
+    unsigned  head, tail;
+    int       slot;
+
+    head = atomic_load_explicit(&ch->head, memory_order_relaxed);
+    tail = atomic_load_explicit(&ch->tail, memory_order_acquire);
+    for (; head != tail; ++head) {
+        msg  = ch->buffer[head % MESSAGES];
+        slot = msg.id & (MESSAGES - 1);
+
+        /* A positive message in this station's past is a straggler, and so
+           is an anti-message whose positive message was already consumed.
+           Roll back every executed event at or after the message time; for
+           an anti-message this puts its positive message back in the inbox. */
+
+        if ((!msg.anti || lp->pending[slot] == NULL) &&
+            lp->snap_tail > lp->snap_head &&
+            lp->snapshots[(lp->snap_tail - 1) & (SNAPSHOTS - 1)].time >= msg.time)
+            rollback(lp, msg.time);
+
+        if (msg.anti) {
+
+            /* Annihilate the positive message. */
+
+            en = lp->pending[slot];
+            lp->pending[slot] = NULL;
+            cancel(lp->inbox, en);
+        }
+        else
+            lp->pending[slot] = push(lp->inbox, msg.time, msg.id);
+    }
+    atomic_store_explicit(&ch->head, head, memory_order_release);
+}
+
+
+void rollback(station *lp, float time)  /* Undo every executed event at or
+                                           after time. */
+{
+    snapshot *sp = NULL;
+    message   anti;
+
+    while (lp->snap_tail > lp->snap_head &&
+           lp->snapshots[(lp->snap_tail - 1) & (SNAPSHOTS - 1)].time >= time) {
+        sp = &lp->snapshots[--lp->snap_tail & (SNAPSHOTS - 1)];
+        ++lp->num_rolled_back;
+
+        /* Return the consumed message to the inbox. */
+
+        if (sp->consumed.time < NEVER)
+            lp->pending[sp->consumed.id & (MESSAGES - 1)] =
+                push(lp->inbox, sp->consumed.time, sp->consumed.id);
+
+        /* Cancel the message sent to the next station. */
+
+        if (sp->sent.time < NEVER) {
+            anti      = sp->sent;
+            anti.anti = 1;
+            send(lp, anti);
+        }
+    }
+
+    /* Restore the state saved before the earliest undone event. */
+
+    if (sp != NULL) {
+        lp->now = sp->before;
+        lcgrandst(lp->now.seed, lp->stream);
+    }
+}
+
+
+void fossil_collect(station *lp, float gvt)  /* Commit and reclaim the events
+                                                before GVT. */
+{
+    snapshot *sp;
+
+    while (lp->snap_head < lp->snap_tail &&
+           lp->snapshots[lp->snap_head & (SNAPSHOTS - 1)].time < gvt) {
+        sp = &lp->snapshots[lp->snap_head++ & (SNAPSHOTS - 1)];
+        ++lp->num_events;
+
+        /* Record a committed send as in transit until it reaches the next
+           station. */
+
+        if (sp->sent.time < NEVER) {
+            update_transit_stats(lp, sp->time);
+            ++lp->num_in_transit;
+            if (lp->num_in_transit > lp->num_in_transit_max)
+                lp->num_in_transit_max = lp->num_in_transit;
+            push(lp->in_transit, sp->sent.time, 0);
+        }
+
+        /* Tell the previous station the consumed message is settled. */
+
+        if (sp->consumed.time < NEVER)
+            ++lp->num_committed;
+    }
+    if (lp->input != NULL)
+        atomic_store(&lp->input->committed, lp->num_committed);
+}
+
+
+void update_time_avg_stats(station *lp, float sim_time)  /* Update area
+                                                            accumulators for
+                                                            time-average
+                                                            statistics. */
+{
+    float time_since_last_event;
+
+    time_since_last_event   = sim_time - lp->now.time_last_event;
+    lp->now.time_last_event = sim_time;
+
+    lp->now.area_num_in_queue  += (lp->now.q_tail - lp->now.q_head) *
+                                  time_since_last_event;
+    lp->now.area_server_status += lp->now.server_status *
+                                  time_since_last_event;
+}
+
+
+void update_transit_stats(station *lp, float sim_time)  /* Retire the
+                                                           customers whose
+                                                           transit ended by
+                                                           sim_time. */
+{
+    e_node *en;
+    float   time_end;
+
+    while (!is_empty(lp->in_transit) &&
+           get_event_time(peek(lp->in_transit)) <= sim_time) {
+        en       = pop(lp->in_transit);
+        time_end = get_event_time(en);
+        free(en);
+        lp->area_num_in_transit += lp->num_in_transit *
+                                   (time_end - lp->time_last_transit);
+        lp->time_last_transit    = time_end;
+        --lp->num_in_transit;
+    }
+    lp->area_num_in_transit += lp->num_in_transit *
+                               (sim_time - lp->time_last_transit);
+    lp->time_last_transit    = sim_time;
+}
+
+
+void report(void)  /* Report generator function. */
+{
+    run_report r;
+    int        i;
+
+    /* Hand a copy of the totals to the writer. */
+
+    r.num_events = r.num_rolled_back = 0;
+    for (i = 0; i < QUEUES; i++) {
+        r.num_custs_delayed[i]   = stations[i].now.num_custs_delayed;
+        r.num_in_transit_max[i]  = stations[i].num_in_transit_max;
+        r.total_of_delays[i]     = stations[i].now.total_of_delays;
+        r.area_num_in_queue[i]   = stations[i].now.area_num_in_queue;
+        r.area_server_status[i]  = stations[i].now.area_server_status;
+        r.area_num_in_transit[i] = stations[i].area_num_in_transit;
+        r.num_events      += stations[i].num_events;
+        r.num_rolled_back += stations[i].num_rolled_back;
+    }
+    aout_put(write_report, &r, sizeof(r));
+}
+
+
+void write_report(FILE *out, const void *record)  /* Compute and write the
+                                                     measures of a run, on
+                                                     the writer thread. */
+{
+    const run_report *r = record;
+    int              i;
+
+    fprintf(out, "\n");
+    for (i = 0; i < QUEUES; i++)
+        fprintf(out, "\nAverage delay in queue (%d)%12.3f minutes\n",
+                i + 1, r->total_of_delays[i] / r->num_custs_delayed[i]);
+    for (i = 0; i < QUEUES; i++)
+        fprintf(out, "\nAverage number in queue (%d)%11.3f\n",
+                i + 1, r->area_num_in_queue[i] / num_time_max);
+    for (i = 0; i < QUEUES; i++)
+        fprintf(out, "\nServer %d utilization%18.3f\n",
+                i + 1, r->area_server_status[i] / num_time_max);
+    for (i = 0; i < QUEUES - 1; i++) {
+        fprintf(out, "\nAverage number in transit (%d)%9.3f\n",
+                i + 1, r->area_num_in_transit[i] / num_time_max);
+        fprintf(out, "\nMost in transit (%d)%19d\n",
+                i + 1, r->num_in_transit_max[i]);
+    }
+    fprintf(out, "\nEvents processed%22ld\n", r->num_events);
+    fprintf(out, "\nEvents rolled back%20ld\n\n", r->num_rolled_back);
+}
+
+
+float expon(float mean, int stream)  /* Exponential variate generation
+                                        function. */
+{
+    /* Return an exponential random variate with mean "mean". */
+
+    return -mean * log(lcgrand(stream));
+}
+
+
+float uniform(float min, float max, int stream)  /* Uniform variate generation
+                                                    function. */
+{
+    /* Return a uniformly distributed random variate between "min" and "max" */
+
+    return min + ((max - min) * lcgrand(stream));
+}
@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include <pthread.h>
+#include "pool.h"
+
+// The block of tasks held by one worker: the tasks from front up to but not
+// including back are still to run.
+typedef struct {
+    pthread_mutex_t lock;
+    int             front, back;
+} deque;
+
+// Shared state of a run.
+typedef struct {
+    deque      blocks[POOL_MAX_WORKERS];
+    int        num_workers;
+    pool_task  fn;
+    void       *arg;
+    pool_stats *stats;
+} pool;
+
+typedef struct {
+    pool *pl;
+    int  id;
+} worker_arg;
+
+// Take the task at the back of worker w's own block, or return -1.
+static int take_own(pool *pl, int w){
+    deque *d = &pl->blocks[w];
+    int   task = -1;
+
+    pthread_mutex_lock(&d->lock);
+    if (d->front < d->back)
+        task = --d->back;
+    pthread_mutex_unlock(&d->lock);
+    return task;
+}
+
+// Steal the task at the front of another worker's block, trying the others
+// in turn from the next one, or return -1 when every block is empty.  No
+// task creates others, so an empty pool stays empty.
+static int steal(pool *pl, int w){
+    deque *d;
+    int   i, task = -1;
+
+    for (i = 1; i < pl->num_workers && task < 0; i++){
+        d = &pl->blocks[(w + i) % pl->num_workers];
+        pthread_mutex_lock(&d->lock);
+        if (d->front < d->back)
+            task = d->front++;
+        pthread_mutex_unlock(&d->lock);
+    }
+    return task;
+}
+
+// Body of a worker: run its own tasks, then steal until none are left.
+static void* work(void *arg){
+    worker_arg *wa = (worker_arg*) arg;
+    pool       *pl = wa->pl;
+    long       steals = 0, done = 0;
+    int        task;
+
+    for (;;){
+        task = take_own(pl, wa->id);
+        if (task < 0){
+            task = steal(pl, wa->id);
+            if (task < 0)
+                break;
+            steals++;
+        }
+        pl->fn(task, wa->id, pl->arg);
+        done++;
+    }
+
+    pl->stats->tasks[wa->id] = done;
+    pthread_mutex_lock(&pl->blocks[0].lock);
+    pl->stats->steals += steals;
+    pthread_mutex_unlock(&pl->blocks[0].lock);
+    return NULL;
+}
+
+// Run tasks 0 to num_tasks - 1 as fn(task, worker, arg) on num_workers
+// threads, the calling thread being worker 0, and fill in stats.  Return 0,
+// or -1 if a thread cannot be started (the tasks are then run by the
+// workers that did start).
+int pool_run(int num_tasks, int num_workers, pool_task fn, void *arg,
+             pool_stats *stats){
+    pool       pl;
+    pthread_t  threads[POOL_MAX_WORKERS];
+    worker_arg args[POOL_MAX_WORKERS];
+    int        w, started, status = 0;
+
+    if (num_workers < 1)
+        num_workers = 1;
+    if (num_workers > POOL_MAX_WORKERS)
+        num_workers = POOL_MAX_WORKERS;
+
+    pl.num_workers = num_workers;
+    pl.fn          = fn;
+    pl.arg         = arg;
+    pl.stats       = stats;
+    stats->num_workers = num_workers;
+    stats->steals      = 0;
+
+    // Deal the tasks out in contiguous blocks.
+    for (w = 0; w < num_workers; w++){
+        pthread_mutex_init(&pl.blocks[w].lock, NULL);
+        pl.blocks[w].front = (long) num_tasks * w / num_workers;
+        pl.blocks[w].back  = (long) num_tasks * (w + 1) / num_workers;
+        stats->tasks[w]    = 0;
+        args[w].pl = &pl;
+        args[w].id = w;
+    }
+
+    for (started = 1; started < num_workers; started++)
+        if (pthread_create(&threads[started], NULL, work, &args[started]) != 0){
+            status = -1;
+            break;
+        }
+    work(&args[0]);
+    for (w = 1; w < started; w++)
+        pthread_join(threads[w], NULL);
+
+    for (w = 0; w < num_workers; w++)
+        pthread_mutex_destroy(&pl.blocks[w].lock);
+    return status;
+}
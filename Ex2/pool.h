@@ -0,0 +1,30 @@
+#ifndef _POOL_H
+#define _POOL_H
+
+/*
+ * The following declarations are used for running a batch of independent
+ * tasks on a pool of threads that balance their load by work stealing.
+ * The tasks, numbered from 0, are dealt out to the workers in contiguous
+ * blocks.  Each worker takes tasks from the back of its own block, and a
+ * worker whose block is empty steals from the front of another's, so
+ * expensive tasks that happen to fall together are spread over the pool as
+ * the run goes on.  A task is told which worker runs it, so it can use
+ * per-worker resources such as a random-number stream, but its results
+ * should depend only on its number.
+ */
+
+#define POOL_MAX_WORKERS 64
+
+typedef void (*pool_task)(int task, int worker, void *arg);
+
+// Counts kept by a run of the pool.
+typedef struct {
+    int  num_workers;
+    long steals;                        // Tasks run away from their block.
+    long tasks[POOL_MAX_WORKERS];       // Tasks run by each worker.
+} pool_stats;
+
+int pool_run(int num_tasks, int num_workers, pool_task, void *arg,
+             pool_stats*);
+
+#endif // _POOL_H
@@ -2,86 +2,158 @@
 #include <stdio.h>
 #include "pq.h"
 
+#define HEAP_INITIAL 64   // Initial capacity of the heap array.
+
 // Definition of an event node.
 struct e_node {
     float time;
     int type;
-    e_node* next;
+    unsigned long seq;    // Order of scheduling, breaks ties in time.
+    int pos;              // Index of this node in the heap array.
 };
 
 // Definition of an event list.
 struct e_list {
-    e_node* head;
+    e_node **heap;
+    int size;
+    int capacity;
+    unsigned long next_seq;
 };
 
+// Check whether node a is due before node b.  Events at equal times are
+// served in the order they were scheduled.
+static int before(e_node *a, e_node *b){
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+// Place a node at a heap position and record the position in the node.
+static void place(e_list *el, e_node *en, int pos){
+    el->heap[pos] = en;
+    en->pos = pos;
+}
+
+// Move the node at pos toward the root until its parent is due before it.
+static void sift_up(e_list *el, int pos){
+    e_node *en = el->heap[pos];
+    while (pos > 0){
+        int parent = (pos - 1) / 2;
+        if (!before(en, el->heap[parent]))
+            break;
+        place(el, el->heap[parent], pos);
+        pos = parent;
+    }
+    place(el, en, pos);
+}
+
+// Move the node at pos toward the leaves until both children are due after it.
+static void sift_down(e_list *el, int pos){
+    e_node *en = el->heap[pos];
+    for (;;){
+        int child = 2 * pos + 1;
+        if (child >= el->size)
+            break;
+        if (child + 1 < el->size && before(el->heap[child + 1], el->heap[child]))
+            child++;
+        if (!before(el->heap[child], en))
+            break;
+        place(el, el->heap[child], pos);
+        pos = child;
+    }
+    place(el, en, pos);
+}
+
+// Take the node at pos out of the heap, keeping the rest ordered.
+static void remove_at(e_list *el, int pos){
+    e_node *last = el->heap[--el->size];
+    if (pos == el->size)
+        return;
+    place(el, last, pos);
+    if (pos > 0 && before(last, el->heap[(pos - 1) / 2]))
+        sift_up(el, pos);
+    else
+        sift_down(el, pos);
+}
+
 // Allocate a new event list.
 e_list* new_list(){
     e_list *el;
     if ((el = (e_list *) malloc(sizeof(e_list))) != NULL) {
-        el->head = NULL;
+        el->heap = (e_node **) malloc(HEAP_INITIAL * sizeof(e_node *));
+        el->size = 0;
+        el->capacity = HEAP_INITIAL;
+        el->next_seq = 0;
     }
     return el;
 }
 
 // Free the passed event list.
 void free_list(e_list *el){
-    while (el->head != NULL){
+    while (el->size > 0){
         e_node *en = pop(el);
         free(en);
     }
+    free(el->heap);
     free(el);
     el = NULL;
 }
 
-// Push a new event node onto the list.
-void push(e_list *el, float time, int type){
+// Push a new event node onto the list, returning a handle to it.
+e_node* push(e_list *el, float time, int type){
     
     // Allocate a new event node
     e_node *en;
     if ((en = (e_node *) malloc(sizeof(e_node))) != NULL) {
         en->time = time;
         en->type = type;
-        en->next = NULL;
+        en->seq = el->next_seq++;
     }
     
-    // Insertion sort
-    // DEVNOTE: Replace with faster implementation if there's time.
-    if (el->head == NULL){
-        el->head = en;
-    } else if (en->time < el->head->time) {
-        // Supplant the head entirely
-        en->next = el->head;
-        el->head = en;
-    } else {
-        // Find the insertion point the new node fits behind
-        e_node *insertion = el->head;
-        while (insertion->next != NULL && insertion->next->time < en->time){
-            insertion = insertion->next;
-        }
-        en->next = insertion->next;
-        insertion->next = en;
+    // Grow the heap array if it is full
+    if (el->size == el->capacity){
+        el->capacity *= 2;
+        el->heap = (e_node **) realloc(el->heap, el->capacity * sizeof(e_node *));
     }
+    
+    // Add at the bottom of the heap and restore the ordering
+    place(el, en, el->size++);
+    sift_up(el, en->pos);
+    return en;
 }
 
 // Peek at the head of the list.
 e_node* peek(e_list *el){
-    return el->head;
+    return el->size > 0 ? el->heap[0] : NULL;
 }
 
-// Pop the head of the list.
+// Pop the head of the list.  The caller owns (and frees) the returned node.
 e_node* pop(e_list *el){
-    e_node *result = el->head;
-    el->head = result->next;
-    result->next = NULL;
+    e_node *result = el->heap[0];
+    remove_at(el, 0);
     return result;
 }
 
-// Print the queue
+// Remove a scheduled event from the list and free it.
+void cancel(e_list *el, e_node *en){
+    remove_at(el, en->pos);
+    free(en);
+}
+
+// Move a scheduled event to a new time.  The event is ordered among events
+// at the same time as if it had just been pushed.
+void reschedule(e_list *el, e_node *en, float time){
+    en->time = time;
+    en->seq = el->next_seq++;
+    if (en->pos > 0 && before(en, el->heap[(en->pos - 1) / 2]))
+        sift_up(el, en->pos);
+    else
+        sift_down(el, en->pos);
+}
+
+// Print the queue (in heap order, not time order)
 void print_list(e_list *el){
-    e_node *en = el->head;
-    while (en != NULL){
-        printf("Event %d at %f -> ", en->type, en->time);
-        en = en->next;
+    int i;
+    for (i = 0; i < el->size; i++){
+        printf("Event %d at %f -> ", el->heap[i]->type, el->heap[i]->time);
     }
     printf("NULL\n");
 }
@@ -98,5 +170,10 @@ int get_event_type(e_node *en){
 
 // Check if the event list is empty.
 int is_empty(e_list *el){
-    return (el->head == NULL);
-}
\ No newline at end of file
+    return (el->size == 0);
+}
+
+// Get the number of events in the list.
+int list_size(e_list *el){
+    return el->size;
+}
@@ -3,7 +3,9 @@
 
 /*
  * The following declarations are used for a simple priority-queue 
- * data structure based on a linked list. 
+ * data structure based on an indexed binary heap.  push returns a handle
+ * to the scheduled event which stays valid until the event is popped or
+ * cancelled, and which can be passed to cancel or reschedule.
  */
 
 typedef struct e_node e_node;
@@ -13,14 +15,17 @@ typedef struct e_list e_list;
 e_list* new_list();
 void    free_list(e_list*);
 
-void    push(e_list*, float, int);
+e_node* push(e_list*, float, int);
 e_node* peek(e_list*);
 e_node* pop(e_list*);
+void    cancel(e_list*, e_node*);
+void    reschedule(e_list*, e_node*, float);
 
 void    print_list(e_list*);
 
 float   get_event_time(e_node*);
 int     get_event_type(e_node*);
 int     is_empty(e_list*);
+int     list_size(e_list*);
 
-#endif // _PQ_H
\ No newline at end of file
+#endif // _PQ_H
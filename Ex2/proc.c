@@ -0,0 +1,209 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "proc.h"
+
+#define POOL_CHUNK   256   // Frames added to the pool at a time.
+#define POOL_CHUNKS 4096   // Most chunks the pool can hold.
+#define WAIT_INITIAL  64   // Initial capacity of a resource wait queue.
+
+float proc_clock;
+long  proc_events;
+
+// The frame pool is a list of chunks that never move once allocated, so a
+// running body keeps a valid frame pointer while other processes start.
+static process *chunks[POOL_CHUNKS];
+static int      num_chunks  = 0;
+static int      free_frames = -1;
+static int      num_active  = 0;
+static e_list  *events      = NULL;
+
+// Find the frame with the given pool index.
+static process* frame(int id){
+    return &chunks[id / POOL_CHUNK][id % POOL_CHUNK];
+}
+
+// Take a frame from the free list, adding a chunk if it is empty.
+static process* alloc_frame(){
+    process *p;
+    int i;
+    if (free_frames < 0){
+        if (num_chunks == POOL_CHUNKS){
+            fprintf(stderr, "Process pool exhausted\n");
+            exit(2);
+        }
+        chunks[num_chunks] = (process *) malloc(POOL_CHUNK * sizeof(process));
+        for (i = POOL_CHUNK - 1; i >= 0; i--){
+            chunks[num_chunks][i].id = num_chunks * POOL_CHUNK + i;
+            chunks[num_chunks][i].next_free = free_frames;
+            free_frames = chunks[num_chunks][i].id;
+        }
+        num_chunks++;
+    }
+    p = frame(free_frames);
+    free_frames = p->next_free;
+    num_active++;
+    return p;
+}
+
+// Return a frame to the free list.
+static void free_frame(process *p){
+    p->next_free = free_frames;
+    free_frames = p->id;
+    num_active--;
+}
+
+// Run a process body until it waits or finishes.
+static void resume(process *p){
+    if (p->body(p) == PROC_DONE)
+        free_frame(p);
+}
+
+// Reset the clock and event list, and return every frame to the pool.  The
+// chunks themselves are kept for the next run.
+void proc_init(){
+    int i, j;
+    proc_clock = 0.0;
+    proc_events = 0;
+    if (events != NULL)
+        free_list(events);
+    events = new_list();
+    free_frames = -1;
+    for (i = num_chunks - 1; i >= 0; i--){
+        for (j = POOL_CHUNK - 1; j >= 0; j--){
+            chunks[i][j].next_free = free_frames;
+            free_frames = chunks[i][j].id;
+        }
+    }
+    num_active = 0;
+}
+
+// Free the event list and the frame pool.
+void proc_free(){
+    int i;
+    if (events != NULL)
+        free_list(events);
+    events = NULL;
+    for (i = 0; i < num_chunks; i++)
+        free(chunks[i]);
+    num_chunks = 0;
+    free_frames = -1;
+    num_active = 0;
+}
+
+// Start a new process at the current time, running it until it first waits.
+process* proc_spawn(proc_body body){
+    process *p = alloc_frame();
+    p->line = 0;
+    p->body = body;
+    resume(p);
+    return p;
+}
+
+// Advance the clock to the next event and resume its process.  Returns 0 if
+// the event list is empty.
+int proc_step(){
+    e_node *event;
+    int id;
+    if (is_empty(events))
+        return 0;
+    event = pop(events);
+    proc_clock = get_event_time(event);
+    id = get_event_type(event);
+    free(event);
+    proc_events++;
+    resume(frame(id));
+    return 1;
+}
+
+// Count the processes that have started and not yet finished.
+int proc_active(){
+    return num_active;
+}
+
+// Schedule a process to resume after the given delay.
+void proc_hold(process *p, float delay){
+    push(events, proc_clock + delay, p->id);
+}
+
+// Request a resource.  Returns 1 if the process got it right away, or 0 if
+// it joined the wait queue, in which case it is resumed holding the resource
+// when it reaches the front.
+int proc_seize(process *p, resource *r){
+    int tail;
+    res_update(r);
+    if (!r->busy){
+        r->busy = 1;
+        r->num_custs_delayed++;
+        return 1;
+    }
+
+    // Grow the wait queue if it is full, unrolling the ring
+    if (r->num_in_queue == r->capacity){
+        int   *waiting = (int *) malloc(2 * r->capacity * sizeof(int));
+        float *time_waiting = (float *) malloc(2 * r->capacity * sizeof(float));
+        int i;
+        for (i = 0; i < r->num_in_queue; i++){
+            waiting[i] = r->waiting[(r->head + i) % r->capacity];
+            time_waiting[i] = r->time_waiting[(r->head + i) % r->capacity];
+        }
+        free(r->waiting);
+        free(r->time_waiting);
+        r->waiting = waiting;
+        r->time_waiting = time_waiting;
+        r->head = 0;
+        r->capacity *= 2;
+    }
+
+    tail = (r->head + r->num_in_queue) % r->capacity;
+    r->waiting[tail] = p->id;
+    r->time_waiting[tail] = proc_clock;
+    r->num_in_queue++;
+    return 0;
+}
+
+// Release a resource.  The process at the front of the wait queue (if any)
+// takes it over and runs at once, before the releasing process continues.
+void proc_release(process *p, resource *r){
+    int id;
+    (void) p;
+    res_update(r);
+    if (r->num_in_queue == 0){
+        r->busy = 0;
+        return;
+    }
+    id = r->waiting[r->head];
+    r->total_of_delays += proc_clock - r->time_waiting[r->head];
+    r->num_custs_delayed++;
+    r->head = (r->head + 1) % r->capacity;
+    r->num_in_queue--;
+    resume(frame(id));
+}
+
+// Initialize a resource as idle with an empty queue and zero statistics.
+void res_init(resource *r){
+    r->busy = 0;
+    r->num_in_queue = 0;
+    r->num_custs_delayed = 0;
+    r->capacity = WAIT_INITIAL;
+    r->head = 0;
+    r->waiting = (int *) malloc(WAIT_INITIAL * sizeof(int));
+    r->time_waiting = (float *) malloc(WAIT_INITIAL * sizeof(float));
+    r->total_of_delays = 0.0;
+    r->area_num_in_queue = 0.0;
+    r->area_busy = 0.0;
+    r->time_last_event = proc_clock;
+}
+
+// Free the wait queue of a resource.
+void res_free(resource *r){
+    free(r->waiting);
+    free(r->time_waiting);
+}
+
+// Update the area accumulators of a resource up to the current time.
+void res_update(resource *r){
+    float time_since_last_event = proc_clock - r->time_last_event;
+    r->time_last_event = proc_clock;
+    r->area_num_in_queue += r->num_in_queue * time_since_last_event;
+    r->area_busy += r->busy * time_since_last_event;
+}
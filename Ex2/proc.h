@@ -0,0 +1,80 @@
+#ifndef _PROC_H
+#define _PROC_H
+
+#include "pq.h"
+
+/*
+ * The following declarations are used for process-interaction modeling on
+ * top of the pq.h event list.  A process is a stackless coroutine: a body
+ * function that is re-entered at the point where it last waited.  Its
+ * frame comes from a pool that grows in fixed chunks and recycles frames,
+ * so starting a process does not allocate once the pool is warm.
+ *
+ * A body is written between PROC_BEGIN and PROC_END, and waits with
+ * PROC_DELAY or PROC_SEIZE.  Locals do not survive a wait; keep anything
+ * needed afterwards in the frame's data area (PROC_VARS).  The body may not
+ * itself contain a switch statement, and only one wait may appear per line.
+ */
+
+#define PROC_DATA   32    // Bytes of per-process variables in a frame.
+#define PROC_WAIT    0    // Mnemonics for a body that is waiting
+#define PROC_DONE    1    // and one that has finished.
+
+typedef struct process  process;
+typedef struct resource resource;
+typedef int (*proc_body)(process*);
+
+// Definition of a process frame.
+struct process {
+    int line;         // Resume point in the body, 0 before the first call.
+    int id;           // Index of the frame in the pool.
+    int next_free;    // Next frame on the free list.
+    proc_body body;
+    union { double align; char bytes[PROC_DATA]; } data;
+};
+
+// Definition of a single-server resource with a FIFO wait queue.  The
+// statistics follow the area-accumulator style of the event models.
+struct resource {
+    int   busy, num_in_queue, num_custs_delayed, capacity, head;
+    int   *waiting;          // Ring of waiting process ids.
+    float *time_waiting;     // Time each waiting process joined the queue.
+    float total_of_delays, area_num_in_queue, area_busy, time_last_event;
+};
+
+#define PROC_VARS(p, type)  ((type *) (p)->data.bytes)
+
+#define PROC_BEGIN(p)       switch ((p)->line) { case 0:
+#define PROC_END(p)         } (p)->line = -1; return PROC_DONE
+
+#define PROC_DELAY(p, d)                                                  \
+    do { proc_hold((p), (d)); (p)->line = __LINE__; return PROC_WAIT;     \
+         case __LINE__:; } while (0)
+
+// A seize that succeeds at once breaks out past its resume point rather
+// than falling into it.
+#define PROC_SEIZE(p, r)                                                  \
+    do { if (!proc_seize((p), (r))) {                                     \
+             (p)->line = __LINE__; return PROC_WAIT; }                    \
+         break; case __LINE__:; } while (0)
+
+#define PROC_RELEASE(p, r)  proc_release((p), (r))
+
+extern float proc_clock;      // Simulation clock.
+extern long  proc_events;     // Events processed since proc_init.
+
+void     proc_init(void);
+void     proc_free(void);
+process* proc_spawn(proc_body);
+int      proc_step(void);
+int      proc_active(void);
+
+void     proc_hold(process*, float);
+int      proc_seize(process*, resource*);
+void     proc_release(process*, resource*);
+
+void     res_init(resource*);
+void     res_free(resource*);
+void     res_update(resource*);
+
+#endif // _PROC_H
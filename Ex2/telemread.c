@@ -0,0 +1,70 @@
+/* Reader for the live snapshots that mm2 and inv publish with the option
+   -m name (see telem.h).
+
+   Usage: telemread name [-w]
+
+   The latest snapshot in the shared-memory segment called name is written
+   to the standard output.  With -w the snapshot is written again every
+   second until the run is done or its process has gone, so a run can be
+   watched, and killed if it has gone wrong, by the process number shown.
+   Reading never blocks the simulator. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include "telem.h"  /* Header file for telemetry segments. */
+
+void show(const telem_data *);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    const telem_segment *seg;
+    telem_data          snap;
+    int                 watch;
+
+    if (argc < 2 || (argc == 3 && strcmp(argv[2], "-w") != 0) || argc > 3) {
+        fprintf(stderr, "Usage: telemread name [-w]\n");
+        exit(1);
+    }
+    watch = argc == 3;
+
+    seg = telem_attach(argv[1]);
+    if (seg == NULL) {
+        fprintf(stderr, "No telemetry segment %s\n", argv[1]);
+        exit(1);
+    }
+
+    for (;;) {
+        telem_read(seg, &snap);
+        show(&snap);
+
+        /* Stop once the run is over, whether or not it said so. */
+
+        if (!watch || snap.state == TELEM_DONE || kill(snap.pid, 0) < 0)
+            break;
+        sleep(1);
+    }
+
+    return 0;
+}
+
+
+void show(const telem_data *snap)  /* Write one snapshot. */
+{
+    int k;
+
+    printf("%s (process %d) %s, run %d\n", snap->model, snap->pid,
+           snap->state == TELEM_DONE ? "done" : "running", snap->run);
+    printf("  Simulated time%24.3f\n", snap->sim_time);
+    printf("  Wall-clock seconds%20.1f\n", snap->wall_time);
+    printf("  Events processed%22llu\n", snap->events);
+    printf("  Events per second%21.0f\n", snap->events_per_sec);
+    for (k = 0; k < snap->num_values; ++k)
+        printf("  %-*s%*.3f\n", TELEM_NAME_LEN, snap->name[k],
+               38 - TELEM_NAME_LEN, snap->value[k]);
+    printf("\n");
+    fflush(stdout);
+}
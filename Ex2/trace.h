@@ -0,0 +1,70 @@
+#ifndef _TRACE_H
+#define _TRACE_H
+
+/*
+ * The following declarations are used for reading recorded input streams,
+ * such as arrival timestamps and job sizes, from a binary columnar trace
+ * file.  The file is mapped into memory rather than read, and each column is
+ * a contiguous array of doubles, so a column is consumed by walking a
+ * pointer.  The kernel is told the file is read sequentially, and each
+ * column reader asks for the next window of its column ahead of use, so a
+ * trace larger than memory streams through the page cache.  Trace files are
+ * written by the tracebin tool from text.
+ */
+
+#include <stddef.h>
+
+#define TRACE_MAGIC       "SIMTRACE"
+#define TRACE_VERSION     1
+#define TRACE_MAX_COLUMNS 8
+#define TRACE_NAME_LEN    16
+#define TRACE_ALIGN       4096          // Alignment of each column in the file.
+#define TRACE_WINDOW      (1 << 20)     // Values read ahead by a column reader.
+
+// Layout of the start of a trace file.  The columns follow, each holding
+// num_records doubles at its offset from the start of the file.
+typedef struct {
+    char               magic[8];
+    unsigned int       version;
+    unsigned int       num_columns;
+    unsigned long long num_records;
+    struct {
+        char               name[TRACE_NAME_LEN];
+        unsigned long long offset;
+    } column[TRACE_MAX_COLUMNS];
+} trace_header;
+
+// An open trace file.
+typedef struct {
+    int                 fd;
+    size_t              map_size;
+    const unsigned char *map;
+    const trace_header  *header;
+} trace_file;
+
+// A sequential reader on one column of a trace file.
+typedef struct {
+    const double *data;
+    long long    next;         // Index of the next value.
+    long long    count;        // Number of values in the column.
+    long long    advised;      // Values up to here have been read ahead.
+} trace_column;
+
+int  trace_open(trace_file*, const char *path);
+void trace_close(trace_file*);
+int  trace_column_open(const trace_file*, const char *name, trace_column*);
+void trace_rewind(trace_column*);
+void trace_advise(trace_column*);
+
+// Store the next value of a column in *value and return 1, or return 0 when
+// the column is used up.
+static inline int trace_next(trace_column *tc, double *value){
+    if (tc->next >= tc->count)
+        return 0;
+    if (tc->next >= tc->advised)
+        trace_advise(tc);
+    *value = tc->data[tc->next++];
+    return 1;
+}
+
+#endif // _TRACE_H
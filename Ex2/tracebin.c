@@ -0,0 +1,163 @@
+/* Conversion of a text trace into the binary columnar format read by the
+   trace-driven models (see trace.h).
+
+   Usage: tracebin in.txt out.bin
+
+   The first line of the text file names the columns, separated by blanks,
+   and each further line holds one record, one number per column.  The
+   models use the columns
+
+       arrival    absolute arrival times, in minutes, in increasing order
+       service1   service times at server 1, in arrival order
+       service2   service times at server 2, in order of reaching server 2
+
+   and ignore any others.  The text is read twice, once to count the records
+   and once to convert them, and the output file is sized in advance and
+   filled through a memory map, so each column is written as one sequential
+   array of doubles. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "trace.h"  /* Header file for trace files. */
+
+#define LINE_LIMIT 4096  /* Limit on the length of a line of text. */
+
+char               line[LINE_LIMIT];
+int                num_columns;
+unsigned long long num_records;
+FILE               *infile;
+
+void read_names(trace_header *);
+void count_records(void);
+void read_records(unsigned char *map, const trace_header *);
+void fail(const char *message);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    trace_header       header;
+    unsigned long long size, column_bytes;
+    unsigned char      *map;
+    int                fd, j;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: tracebin in.txt out.bin\n");
+        exit(1);
+    }
+
+    /* Open the text file, name the columns and count the records. */
+
+    infile = fopen(argv[1], "r");
+    if (infile == NULL)
+        fail("Cannot open the text trace");
+    memset(&header, 0, sizeof(header));
+    read_names(&header);
+    count_records();
+
+    /* Lay the columns out one after another, each starting on a page. */
+
+    memcpy(header.magic, TRACE_MAGIC, 8);
+    header.version     = TRACE_VERSION;
+    header.num_columns = num_columns;
+    header.num_records = num_records;
+    column_bytes = (num_records * sizeof(double) + TRACE_ALIGN - 1) /
+                   TRACE_ALIGN * TRACE_ALIGN;
+    size = TRACE_ALIGN;
+    for (j = 0; j < num_columns; ++j) {
+        header.column[j].offset = size;
+        size += column_bytes;
+    }
+
+    /* Size the output file and map it. */
+
+    fd = open(argv[2], O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fail("Cannot create the binary trace");
+    if (ftruncate(fd, (off_t) size) < 0)
+        fail("Cannot size the binary trace");
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED)
+        fail("Cannot map the binary trace");
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    /* Write the header, then read the text again to fill the columns. */
+
+    memcpy(map, &header, sizeof(header));
+    rewind(infile);
+    if (fgets(line, LINE_LIMIT, infile) == NULL)
+        fail("Cannot read the text trace again");
+    read_records(map, &header);
+
+    munmap(map, size);
+    close(fd);
+    fclose(infile);
+
+    printf("%llu records in %d columns\n", num_records, num_columns);
+
+    return 0;
+}
+
+
+void read_names(trace_header *header)  /* Read the column names from the
+                                          first line. */
+{
+    char *name;
+
+    if (fgets(line, LINE_LIMIT, infile) == NULL)
+        fail("The text trace is empty");
+    if (strchr(line, '\n') == NULL && !feof(infile))
+        fail("The first line is too long");
+    for (name = strtok(line, " \t\r\n"); name != NULL;
+         name = strtok(NULL, " \t\r\n")) {
+        if (num_columns == TRACE_MAX_COLUMNS)
+            fail("Too many columns");
+        if (strlen(name) >= TRACE_NAME_LEN)
+            fail("Column name too long");
+        strcpy(header->column[num_columns++].name, name);
+    }
+    if (num_columns == 0)
+        fail("No column names on the first line");
+}
+
+
+void count_records(void)  /* Count the lines holding records. */
+{
+    while (fgets(line, LINE_LIMIT, infile) != NULL)
+        if (strspn(line, " \t\r\n") < strlen(line))
+            ++num_records;
+}
+
+
+void read_records(unsigned char *map, const trace_header *header)
+    /* Convert each record into its place in the columns. */
+{
+    unsigned long long n = 0;
+    char               *p, *end;
+    int                j;
+
+    while (n < num_records && fgets(line, LINE_LIMIT, infile) != NULL) {
+        if (strspn(line, " \t\r\n") == strlen(line))
+            continue;
+        p = line;
+        for (j = 0; j < num_columns; ++j) {
+            ((double *) (map + header->column[j].offset))[n] = strtod(p, &end);
+            if (end == p) {
+                fprintf(stderr, "Record %llu: ", n + 1);
+                fail("too few numbers");
+            }
+            p = end;
+        }
+        ++n;
+    }
+}
+
+
+void fail(const char *message)  /* Report an error and stop. */
+{
+    fprintf(stderr, "%s\n", message);
+    exit(1);
+}
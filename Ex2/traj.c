@@ -0,0 +1,284 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include "traj.h"
+
+// A series being recorded: the value it holds since time last, and the
+// buckets it has covered so far.
+typedef struct {
+    int    value;
+    double last;
+    int    min[TRAJ_BUCKETS], max[TRAJ_BUCKETS];
+    double area[TRAJ_BUCKETS];
+} traj_series;
+
+// State of the writer.
+static FILE          *file;
+static int           num_series, run_number;
+static double        width;
+static traj_series   *series;
+static long long     column[TRAJ_BUCKETS];
+static unsigned char *encoded;
+
+// Put one bucket's worth of a held value into bucket b.
+static void cover(traj_series *s, int b, int value, double span){
+    if (value < s->min[b])
+        s->min[b] = value;
+    if (value > s->max[b])
+        s->max[b] = value;
+    s->area[b] += value * span;
+}
+
+// Merge each pair of buckets into one of twice the width.
+static void coarsen(void){
+    int         k, b;
+    traj_series *s;
+
+    for (k = 0; k < num_series; ++k){
+        s = &series[k];
+        for (b = 0; b < TRAJ_BUCKETS / 2; ++b){
+            s->min[b]  = s->min[2 * b] < s->min[2 * b + 1] ? s->min[2 * b]
+                                                           : s->min[2 * b + 1];
+            s->max[b]  = s->max[2 * b] > s->max[2 * b + 1] ? s->max[2 * b]
+                                                           : s->max[2 * b + 1];
+            s->area[b] = s->area[2 * b] + s->area[2 * b + 1];
+        }
+        for (; b < TRAJ_BUCKETS; ++b){
+            s->min[b]  = INT_MAX;
+            s->max[b]  = INT_MIN;
+            s->area[b] = 0.0;
+        }
+    }
+    width *= 2;
+}
+
+// Index of the bucket holding time, coarsening until there is one.
+static int bucket(double time){
+    while (time >= width * TRAJ_BUCKETS)
+        coarsen();
+    return (int) (time / width);
+}
+
+// Spread the value s has held since its last change up to time.
+static void advance(traj_series *s, double time){
+    int    b;
+    double end;
+
+    if (time <= s->last)
+        return;
+    bucket(time);
+    b = bucket(s->last);
+    while (s->last < time){
+        end = (b + 1) * width;
+        if (end <= s->last){     // Rounding put last at the end of b.
+            ++b;
+            continue;
+        }
+        if (end > time)
+            end = time;
+        cover(s, b, s->value, end - s->last);
+        s->last = end;
+        ++b;
+    }
+}
+
+// Append n values at p as zigzag variable-length differences.
+static unsigned char* encode(unsigned char *p, const long long v[], int n){
+    long long          prev = 0, d;
+    unsigned long long z;
+    int                i;
+
+    for (i = 0; i < n; ++i){
+        d    = v[i] - prev;
+        z    = (unsigned long long) d << 1 ^ (unsigned long long) (d >> 63);
+        prev = v[i];
+        while (z >= 0x80){
+            *p++ = (unsigned char) (z | 0x80);
+            z >>= 7;
+        }
+        *p++ = (unsigned char) z;
+    }
+    return p;
+}
+
+// Create the file at path for num_series series with the given names.
+// Return 0, or -1 if it cannot be created.
+int traj_open(const char *path, int num_series_in, const char *const name[]){
+    traj_header header;
+    int         k;
+
+    if (num_series_in < 1 || num_series_in > TRAJ_SERIES)
+        return -1;
+    // The levels hold under 2 * TRAJ_BUCKETS buckets of three columns a
+    // series, and a value takes at most 10 bytes.
+    series  = malloc(num_series_in * sizeof(traj_series));
+    encoded = malloc((size_t) 2 * TRAJ_BUCKETS * 3 * num_series_in * 10);
+    file = fopen(path, "wb");
+    if (series == NULL || encoded == NULL || file == NULL){
+        free(series);
+        free(encoded);
+        if (file != NULL)
+            fclose(file);
+        file = NULL;
+        return -1;
+    }
+    num_series = num_series_in;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, TRAJ_MAGIC, 8);
+    header.version    = TRAJ_VERSION;
+    header.num_series = num_series;
+    for (k = 0; k < num_series; ++k)
+        strncpy(header.name[k], name[k], TRAJ_NAME_LEN - 1);
+    fwrite(&header, sizeof(header), 1, file);
+    return 0;
+}
+
+// Start recording run number run, with every series 0 at time 0.  The
+// buckets start wide enough to cover time_hint, if it is positive, with
+// TRAJ_SPARE buckets to spare, so a run that stops at the first event past
+// it does not coarsen at the very end.
+void traj_begin(int run, double time_hint){
+    int k, b;
+
+    if (file == NULL)
+        return;
+    run_number = run;
+    width = time_hint > 0 ? time_hint / (TRAJ_BUCKETS - TRAJ_SPARE) : 1.0;
+    for (k = 0; k < num_series; ++k){
+        series[k].value = 0;
+        series[k].last  = 0.0;
+        for (b = 0; b < TRAJ_BUCKETS; ++b){
+            series[k].min[b]  = INT_MAX;
+            series[k].max[b]  = INT_MIN;
+            series[k].area[b] = 0.0;
+        }
+    }
+}
+
+// Note that series k takes value at time.  Times must not decrease.
+void traj_record(int k, double time, int value){
+    traj_series *s;
+
+    if (file == NULL || series[k].value == value)
+        return;
+    s = &series[k];
+    advance(s, time);
+    s->value = value;
+    cover(s, bucket(time), value, 0.0);
+}
+
+// End the run at time and write its buckets at every level.
+void traj_end(double time){
+    traj_run      head;
+    traj_series   *s;
+    unsigned char *p;
+    int           k, b, n, level;
+    double        start, span;
+
+    if (file == NULL)
+        return;
+    for (k = 0; k < num_series; ++k)
+        advance(&series[k], time);
+
+    // The buckets in use end with the one holding time, unless time falls
+    // exactly on the start of a bucket.
+    n = time > 0 ? bucket(time) + 1 : 0;
+    if (n > 1 && (n - 1) * width >= time)
+        --n;
+
+    memset(&head, 0, sizeof(head));
+    head.run         = run_number;
+    head.num_buckets = n;
+    head.width       = width;
+    head.time_end    = time;
+
+    // Write each level, then merge its pairs of buckets into the next.
+    p = encoded;
+    for (level = 0; n > 0; ++level){
+        for (k = 0; k < num_series; ++k){
+            s = &series[k];
+            for (b = 0; b < n; ++b)
+                column[b] = s->min[b];
+            p = encode(p, column, n);
+            for (b = 0; b < n; ++b)
+                column[b] = s->max[b];
+            p = encode(p, column, n);
+            for (b = 0; b < n; ++b){
+                start = b * width;
+                span  = (b + 1) * width < time ? width : time - start;
+                column[b] = llround(s->area[b] / span * TRAJ_SCALE);
+            }
+            p = encode(p, column, n);
+        }
+        // The buckets past n are empty, so an odd one out merges with
+        // nothing.
+        if (n == 1)
+            n = 0;
+        else {
+            coarsen();
+            n = (n + 1) / 2;
+        }
+    }
+    head.num_levels = level;
+    head.bytes      = p - encoded;
+    fwrite(&head, sizeof(head), 1, file);
+    fwrite(encoded, 1, head.bytes, file);
+}
+
+// Close the file.
+void traj_close(void){
+    if (file == NULL)
+        return;
+    fclose(file);
+    free(series);
+    free(encoded);
+    file = NULL;
+}
+
+// Read and check the header of a trajectory file.  Return 0, or -1 if it is
+// not one.
+int traj_read_header(FILE *f, traj_header *header){
+    if (fread(header, sizeof(*header), 1, f) != 1 ||
+        memcmp(header->magic, TRAJ_MAGIC, 8) != 0 ||
+        header->version != TRAJ_VERSION ||
+        header->num_series < 1 || header->num_series > TRAJ_SERIES)
+        return -1;
+    return 0;
+}
+
+// Read the next run and its encoded levels, which the caller frees.
+// Return NULL at the end of the file.
+unsigned char* traj_read_run(FILE *f, traj_run *head){
+    unsigned char *data;
+
+    if (fread(head, sizeof(*head), 1, f) != 1)
+        return NULL;
+    data = malloc(head->bytes + 1);
+    if (data == NULL || fread(data, 1, head->bytes, f) != head->bytes){
+        free(data);
+        return NULL;
+    }
+    return data;
+}
+
+// Decode n values written by encode from p, and return the position after.
+const unsigned char* traj_decode(const unsigned char *p, long long out[],
+                                 int n){
+    long long          prev = 0;
+    unsigned long long z;
+    int                i, shift;
+
+    for (i = 0; i < n; ++i){
+        z = 0;
+        for (shift = 0; ; shift += 7){
+            z |= (unsigned long long) (*p & 0x7f) << shift;
+            if ((*p++ & 0x80) == 0)
+                break;
+        }
+        prev += (long long) (z >> 1) ^ -(long long) (z & 1);
+        out[i] = prev;
+    }
+    return p;
+}
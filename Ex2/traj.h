@@ -0,0 +1,66 @@
+#ifndef _TRAJ_H
+#define _TRAJ_H
+
+/*
+ * The following declarations are used for recording the trajectories of
+ * integer state variables, such as queue lengths, over long runs in a file
+ * of bounded size.  The run is divided into at most TRAJ_BUCKETS buckets of
+ * equal width, and each bucket keeps the minimum, maximum and time-average
+ * of each series over it; when the run outgrows the buckets, neighbouring
+ * pairs are merged and the width doubles, so the memory and the output do
+ * not depend on the length of the run.  At the end of a run the buckets are
+ * written at every resolution from the finest down to a single bucket, each
+ * level half the size of the one before, so a plot of any width can read
+ * just the level it needs.
+ *
+ * Each column of a level is stored as differences from the bucket before,
+ * zigzag-mapped to unsigned and written as variable-length integers of 7
+ * bits a byte; neighbouring buckets of a queue length seldom differ by 64,
+ * so most values take one byte.  Means are stored in units of 1/TRAJ_SCALE.
+ */
+
+#include <stdio.h>
+
+#define TRAJ_MAGIC      "SIMTRAJ"  // File identification, with its NUL.
+#define TRAJ_VERSION    1
+#define TRAJ_SERIES     8          // Limit on series in a file.
+#define TRAJ_NAME_LEN   16         // Length of a series name.
+#define TRAJ_BUCKETS    4096       // Buckets at the finest level, even.
+#define TRAJ_SPARE      64         // Buckets past the time hint at the start.
+#define TRAJ_SCALE      256        // Resolution of the stored means.
+
+// Start of a trajectory file.
+typedef struct {
+    char magic[8];
+    int  version;
+    int  num_series;
+    char name[TRAJ_SERIES][TRAJ_NAME_LEN];
+} traj_header;
+
+// Start of each run in the file, followed by bytes of encoded levels.  Level
+// l has ceil(num_buckets / 2^l) buckets, and holds for each series in turn
+// its columns of minima, maxima and means.
+typedef struct {
+    int                run;
+    int                num_levels;
+    int                num_buckets;   // At level 0.
+    int                unused;
+    double             width;         // Of a bucket at level 0, in minutes.
+    double             time_end;      // The last bucket ends here.
+    unsigned long long bytes;
+} traj_run;
+
+// Writer side.
+int  traj_open(const char *path, int num_series, const char *const name[]);
+void traj_begin(int run, double time_hint);
+void traj_record(int k, double time, int value);
+void traj_end(double time);
+void traj_close(void);
+
+// Reader side.
+int                  traj_read_header(FILE *f, traj_header *);
+unsigned char*       traj_read_run(FILE *f, traj_run *);
+const unsigned char* traj_decode(const unsigned char *p, long long out[],
+                                 int n);
+
+#endif // _TRAJ_H
@@ -0,0 +1,110 @@
+/* Reader for the queue-length trajectories that mm2 records with the option
+   -q file (see traj.h).
+
+   Usage: trajdump file [level]
+
+   For each run in the file, the buckets at the given level (0, the finest,
+   by default) are written to the standard output, one line per bucket: the
+   time the bucket starts, then the minimum, maximum and time-average of
+   each series over it.  A level past the coarsest of a run gives its
+   coarsest, a single bucket for the whole run. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "traj.h"  /* Header file for trajectory files. */
+
+long long minimum[TRAJ_SERIES][TRAJ_BUCKETS],
+          maximum[TRAJ_SERIES][TRAJ_BUCKETS],
+          mean[TRAJ_SERIES][TRAJ_BUCKETS];
+
+void show(const traj_header *, const traj_run *, const unsigned char *data,
+          int level);
+
+
+int main(int argc, char *argv[])  /* Main function. */
+{
+    FILE          *f;
+    traj_header   header;
+    traj_run      run;
+    unsigned char *data;
+    int           level = 0;
+
+    if (argc < 2 || argc > 3) {
+        fprintf(stderr, "Usage: trajdump file [level]\n");
+        exit(1);
+    }
+    if (argc == 3)
+        level = atoi(argv[2]);
+
+    f = fopen(argv[1], "rb");
+    if (f == NULL || traj_read_header(f, &header) < 0) {
+        fprintf(stderr, "No trajectory file %s\n", argv[1]);
+        exit(1);
+    }
+
+    while ((data = traj_read_run(f, &run)) != NULL) {
+
+        /* The buckets are decoded into arrays of TRAJ_BUCKETS, so a run
+           with more, or with none, is not from a file traj.c wrote. */
+
+        if (run.num_buckets < 1 || run.num_buckets > TRAJ_BUCKETS ||
+            run.num_levels < 1) {
+            fprintf(stderr, "Bad run in trajectory file %s\n", argv[1]);
+            exit(1);
+        }
+        show(&header, &run, data, level);
+        free(data);
+    }
+
+    fclose(f);
+
+    return 0;
+}
+
+
+void show(const traj_header *header, const traj_run *run,
+          const unsigned char *data, int level)  /* Write one level of a
+                                                    run. */
+{
+    const unsigned char *p = data;
+    double              width = run->width;
+    int                 l, k, b, n = run->num_buckets;
+
+    if (level >= run->num_levels)
+        level = run->num_levels - 1;
+
+    /* Skip the finer levels, decoding each, since the values are of
+       variable length. */
+
+    for (l = 0; l <= level; ++l) {
+        for (k = 0; k < header->num_series; ++k) {
+            p = traj_decode(p, minimum[k], n);
+            p = traj_decode(p, maximum[k], n);
+            p = traj_decode(p, mean[k], n);
+        }
+        if (l < level) {
+            n = (n + 1) / 2;
+            width *= 2;
+        }
+    }
+
+    /* Write the heading and the buckets. */
+
+    printf("Run %d, level %d: %d buckets of %.6g minutes to %.3f minutes\n\n",
+           run->run, level, n, width, run->time_end);
+    printf("%12s", "Time");
+    for (k = 0; k < header->num_series; ++k)
+        printf("  %-22s", header->name[k]);
+    printf("\n%12s", "");
+    for (k = 0; k < header->num_series; ++k)
+        printf("  %6s %6s %8s", "min", "max", "mean");
+    printf("\n");
+    for (b = 0; b < n; ++b) {
+        printf("%12.3f", b * width);
+        for (k = 0; k < header->num_series; ++k)
+            printf("  %6lld %6lld %8.3f", minimum[k][b], maximum[k][b],
+                   (double) mean[k][b] / TRAJ_SCALE);
+        printf("\n");
+    }
+    printf("\n");
+}